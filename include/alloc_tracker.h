@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+
+// Opt-in heap allocation tracking. Counting only happens when the build defines
+// ARTILLERY_TRACK_ALLOCATIONS, which replaces the global operator new/delete.
+// The thread that calls beginFrame is the frame thread; allocations on worker
+// threads are reported separately and never count towards a frame's total.
+class AllocTracker {
+public:
+    enum class Subsystem { Other, Input, Update, Render, Count };
+
+    static constexpr int SUBSYSTEM_COUNT = static_cast<int>(Subsystem::Count);
+    static constexpr std::size_t MAX_CALL_SITES = 256;
+    static constexpr std::size_t MAX_FUNCTION_NAME = 160;
+
+    struct Counters {
+        std::size_t allocations;
+        std::size_t bytes;
+    };
+
+    struct FrameStats {
+        Counters total;  // Frame thread only
+        Counters subsystems[SUBSYSTEM_COUNT];
+        Counters background;  // All other threads during the same frame
+    };
+
+    // The first frame outside the standard library and the tracker, i.e. the code
+    // that asked for memory rather than std::allocator. function is empty when the
+    // frame has no symbol (POSIX builds need exported symbols, see CMakeLists.txt).
+    struct CallSite {
+        const void* address;
+        char function[MAX_FUNCTION_NAME];
+        std::size_t allocations;
+        std::size_t bytes;
+    };
+
+    // Attributes allocations made on the current thread to a subsystem while alive
+    class Scope {
+    public:
+        explicit Scope(Subsystem subsystem);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Subsystem previous;
+    };
+
+    static bool isEnabled();
+    static void beginFrame();
+    static FrameStats endFrame();
+    static const char* getSubsystemName(Subsystem subsystem);
+
+    // Frame-thread call sites since the last beginFrame. Only recorded in debug
+    // builds; returns the number written
+    static std::size_t getCallSites(CallSite* out, std::size_t maxCount);
+
+    static void recordAllocation(std::size_t bytes, const void* callSite);
+};
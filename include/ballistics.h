@@ -0,0 +1,24 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Headless projectile simulation: ShotRules::step run until the shell lands
+namespace Ballistics {
+    struct Params {
+        sf::Vector2f shooter;
+        sf::Vector2f target;
+        float gravity;
+        float powerMultiplier;
+        int worldHeight;
+    };
+
+    struct Outcome {
+        sf::Vector2f impact;
+        float missDistance;  // Zero when the shell hits the target tank
+        int minColumn;       // Columns the trajectory passed over
+        int maxColumn;
+        bool hitTarget;
+    };
+
+    Outcome simulate(const Params& params, const std::vector<float>& heights, float angle, float power);
+}
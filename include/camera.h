@@ -0,0 +1,29 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+// Scrolling view over a world that can be wider than the window. The view is
+// anchored to the bottom of the world and follows its target horizontally.
+class Camera {
+public:
+    Camera(const sf::Vector2f& viewSize, const sf::Vector2f& worldSize);
+
+    void follow(const sf::Vector2f& target, sf::Time deltaTime);
+    void snapTo(const sf::Vector2f& target);
+    void adjustZoom(float factor);
+
+    const sf::View& getView() const;
+    sf::FloatRect getVisibleArea() const;
+
+private:
+    static constexpr float MIN_ZOOM = 0.5f;
+    static constexpr float MAX_ZOOM = 2.0f;
+    static constexpr float FOLLOW_SPEED = 5.0f;
+
+    sf::Vector2f viewSize;
+    sf::Vector2f worldSize;
+    float centerX;
+    float zoom;
+    sf::View view;
+
+    void applyView();
+};
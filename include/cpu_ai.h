@@ -0,0 +1,117 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "outcome_map.h"
+
+// Runs CPU shot searches on a worker thread. A search is an anytime task: it keeps
+// the best shot found so far and publishes it when the wall-clock budget runs out,
+// so the frame loop only ever polls for the result. Each search starts from the
+// cached outcome map, refreshed only where the terrain changed since the last turn;
+// that refresh counts against the same budget and stops early when cancelled.
+// An optional prior (a shot that worked in a similar situation before) picks
+// between equally good map cells and competes with the seed as a start point.
+class CpuAI {
+public:
+    struct Request {
+        sf::Vector2f shooter;
+        sf::Vector2f target;
+        float seedAngle;
+        float seedPower;
+        bool hasPrior;      // priorAngle/priorPower came from an earlier near-hit (see ShotLog)
+        float priorAngle;
+        float priorPower;
+        float gravity;
+        float powerMultiplier;
+        std::chrono::microseconds budget;
+        std::uint32_t seed;
+    };
+
+    struct Decision {
+        float angle;
+        float power;
+        float missDistance;
+        int evaluated;
+        bool completed;  // True when a direct hit was found before the deadline
+    };
+
+    CpuAI(int maxColumns, int worldHeight);
+    ~CpuAI();
+
+    CpuAI(const CpuAI&) = delete;
+    CpuAI& operator=(const CpuAI&) = delete;
+
+    // Starts a new search, cancelling any search still in progress
+    void start(const Request& request, const std::vector<float>& heights);
+    // Returns true once the current search has published its decision
+    bool poll(Decision& decision);
+    void cancel();
+    bool isThinking() const;
+
+    // Terrain changes are queued and applied to the outcome map by the next search.
+    // Ranges are kept apart so distant craters only dirty their own trajectories.
+    void invalidateColumns(int first, int last);
+    void invalidateAll();
+
+    // Copies the latest outcome map miss distances (negative when unknown) if newer than version
+    bool copyHeatmap(std::vector<float>& out, std::uint64_t& version) const;
+
+private:
+    static constexpr float REFINE_ANGLE_RANGE = 4.0f;
+    static constexpr float REFINE_POWER_RANGE = 4.0f;
+    static constexpr std::size_t MAX_QUEUED_RANGES = 16;
+
+    struct ColumnSpan {
+        int first;
+        int last;
+    };
+
+    int worldHeight;
+
+    mutable std::mutex mutex;
+    std::condition_variable_any wakeup;
+
+    // Job slot, guarded by mutex
+    Request pendingRequest;
+    std::vector<float> pendingHeights;
+    bool jobPending;
+    bool searching;
+
+    // Result slot, guarded by mutex
+    Decision result;
+    bool resultReady;
+    std::uint64_t resultGeneration;
+
+    // Queued map invalidation, guarded by mutex
+    std::array<ColumnSpan, MAX_QUEUED_RANGES> invalidRanges;
+    std::size_t invalidRangeCount;
+    bool invalidEverything;
+
+    // Published heatmap, guarded by mutex
+    std::vector<float> heatmap;
+    std::uint64_t heatmapVersion;
+
+    // Bumped by start/cancel; a running search stops once it no longer matches
+    std::atomic<std::uint64_t> generation;
+
+    // Worker-owned state
+    Request activeRequest;
+    std::vector<float> activeHeights;
+    std::mt19937 rng;
+    OutcomeMap outcomeMap;
+
+    std::jthread worker;
+
+    void workerLoop(std::stop_token stopToken);
+    Decision search(std::uint64_t jobGeneration, std::stop_token stopToken,
+                    std::chrono::steady_clock::time_point deadline);
+    void refreshOutcomeMap(std::uint64_t jobGeneration, std::chrono::steady_clock::time_point deadline);
+    Ballistics::Params getActiveParams() const;
+};
@@ -1,11 +1,10 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <random>
 #include <string>
 #include <memory>
-#include "Tank.h"
-#include "Terrain.h"
 #include "Menu.h"
+#include "alloc_tracker.h"
+#include "game_session.h"
 
 class Game {
 public:
@@ -16,9 +15,11 @@ private:
     // Window constants
     static constexpr int WINDOW_WIDTH = 800;
     static constexpr int WINDOW_HEIGHT = 600;
-    static constexpr int TURN_TIME = 600; // 10 seconds at 60 FPS
-    static constexpr float GRAVITY = 981.0f;
-    static constexpr float POWER_SPEED = 1.0f;  // Speed of power oscillation
+    static constexpr float CULL_MARGIN = 40.0f;
+    static constexpr float ZOOM_STEP = 1.1f;
+    static constexpr int ALLOCATION_WARMUP_FRAMES = 60;
+    static constexpr unsigned DEBUG_TEXT_SIZE = 14;
+    static constexpr const char* SHOT_LOG_PATH = "shot_log.bin";
 
     // Core SFML components
     sf::RenderWindow window;
@@ -29,55 +30,46 @@ private:
     // Font and text elements
     sf::Font gameFont;
     sf::Text timerText;
+    int displayedSeconds;
+    sf::Text debugText;
+
+    // Power meter shapes, reused every frame
+    sf::RectangleShape powerMeterBackground;
+    sf::RectangleShape powerMeterFill;
+    sf::RectangleShape previousPowerMarker;
 
     // Game objects
     std::unique_ptr<Menu> menu;
-    std::unique_ptr<Tank> playerTank;
-    std::unique_ptr<Tank> cpuTank;
-    std::unique_ptr<Terrain> terrain;
-
-    // Projectile properties
-    sf::CircleShape projectile;
-    sf::Vector2f projectileVelocity;
-    bool isShooting;
-    Tank* currentShootingTank{};
+    GameSession session;
 
-    struct ShotData {
-        float angle;
-        float power;
-        sf::Vector2f impactPoint;
-        bool wasClose;
+    // Tanks sorted by x for culling
+    struct EntityEntry {
+        float x;
+        const Tank* tank;
     };
-    std::vector<ShotData> previousShots;
-    float learningRate = 0.2f;
-    float integralError = 0.0f;
-    float lastError = 0.0f;
+    std::vector<EntityEntry> entityIndex;
 
-    // Power meter properties
-    float power;
-    float powerDirection;
-    float lastPlayerPower;
+    sf::CircleShape projectile;
 
-    // Game state
-    int turnTimer;
-    bool playerTurn;
+    // Allocation tracking (only active in ARTILLERY_TRACK_ALLOCATIONS builds)
+    int steadyFrames;
+    std::size_t allocatingFrames;
 
-    // Random number generation
-    std::random_device rd;
-    std::mt19937 rng;
+    // Debug heatmap of the CPU outcome map (toggled with F3)
+    bool showOutcomeOverlay;
+    std::vector<float> heatmapValues;
+    std::uint64_t heatmapVersion;
+    std::vector<sf::Uint8> heatmapPixels;
+    sf::Texture heatmapTexture;
+    sf::Sprite heatmapSprite;
 
     // Game functions
     void handleInput();
     void update(sf::Time deltaTime);
     void render();
     void initializeGame();
-    void shoot(const Tank& tank);
-    void updateProjectile(sf::Time deltaTime);
-    void checkCollisions();
-    void switchTurn();
-    void handleCPUTurn();
-
-    // Utility functions
-    float generateRandomFloat(float min, float max);
-    int generateRandomInt(int min, int max);
+    void updateOutcomeOverlay();
+    void refreshDebugText();
+    void drawVisibleEntities(const sf::FloatRect& visible);
+    void checkFrameAllocations(const AllocTracker::FrameStats& stats);
 };
@@ -0,0 +1,125 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include "tank.h"
+#include "terrain.h"
+#include "ring_buffer.h"
+#include "cpu_ai.h"
+#include "camera.h"
+#include "match_preloader.h"
+#include "shot_log.h"
+#include "shot_rules.h"
+
+// The per-frame game logic that needs no window: turns, the shell in flight, the
+// CPU opponent, the shot log, the camera and the power meter. Game feeds it input
+// and draws it; the headless frame allocation check drives the same calls.
+class GameSession {
+public:
+    static constexpr int WORLD_WIDTH = ShotRules::WORLD_WIDTH;
+    static constexpr int WORLD_HEIGHT = ShotRules::WORLD_HEIGHT;
+    static constexpr int TURN_TIME = ShotRules::TURN_TIME;
+    static constexpr float POWER_SPEED = 1.0f;  // Speed of power oscillation
+    static constexpr std::chrono::microseconds CPU_THINK_BUDGET{150000};
+    static constexpr std::size_t SHOT_HISTORY_SIZE = 3;
+
+    // What a frame changed that the caller may need to react to
+    enum class Event { None, Crater, RoundOver };
+
+    GameSession(const sf::Vector2f& viewSize, std::uint32_t seed, const std::string& shotLogPath);
+
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    // Starts a new round from a preloaded match, or builds one now if none is ready.
+    // Must be called once before the first update.
+    void reset();
+
+    // Player controls; ignored unless it is the player's turn and no shell is flying
+    void adjustPlayerAngle(float delta);
+    void updatePowerMeter(bool spacePressed);
+    void releaseShot();
+
+    Event update(sf::Time deltaTime);
+
+    Camera& getCamera();
+    const Terrain& getTerrain() const;
+    const Tank& getPlayerTank() const;
+    const Tank& getCpuTank() const;
+    bool isShooting() const;
+    sf::Vector2f getShellPosition() const;
+    bool isPlayerTurn() const;
+    bool canPlayerAct() const;
+    int getTurnTimer() const;
+    float getPower() const;
+    float getLastPlayerPower() const;
+    std::size_t getShotLogSize() const;
+    sf::Int64 getLastResetMicros() const;
+    bool wasLastResetPreloaded() const;
+    bool copyHeatmap(std::vector<float>& out, std::uint64_t& version) const;
+
+private:
+    struct ShotData {
+        float angle;
+        float power;
+        sf::Vector2f impactPoint;
+        bool wasClose;
+    };
+
+    std::unique_ptr<Tank> playerTank;
+    std::unique_ptr<Tank> cpuTank;
+    std::unique_ptr<Terrain> terrain;
+    Camera camera;
+
+    // Shell in flight
+    sf::Vector2f shell;
+    sf::Vector2f shellVelocity;
+    bool shooting;
+
+    // The shot in flight, as it will be recorded in the shot log
+    sf::Vector2f shotOrigin;
+    sf::Vector2f shotTarget;
+    float shotAngle;
+    float shotPower;
+    float shotRidge;
+
+    RingBuffer<ShotData, SHOT_HISTORY_SIZE> previousShots;
+
+    // Every shot from every session, used to seed the CPU search
+    ShotLog shotLog;
+
+    // Power meter
+    float power;
+    float powerDirection;
+    float lastPlayerPower;
+    bool wasSpacePressed;
+
+    // Turn state
+    int turnTimer;
+    bool playerTurn;
+
+    std::mt19937 rng;
+
+    // CPU shot search, run off the frame thread
+    CpuAI cpuAI;
+    bool cpuDecisionPending;
+
+    // Upcoming rounds built in the background, and how long the last reset took
+    MatchPreloader preloader;
+    sf::Int64 lastResetMicros;
+    bool lastResetPreloaded;
+
+    void shoot(const Tank& tank);
+    Event resolveShot(ShotRules::Result result);
+    void recordShot(sf::Vector2f impact, bool hit);
+    void switchTurn();
+    void handleCPUTurn();
+    void startCPUSearch();
+    void updateCamera(sf::Time deltaTime);
+
+    float generateRandomFloat(float min, float max);
+    int generateRandomInt(int min, int max);
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+
+// Minimal line-oriented Unix domain socket helpers shared by the match server
+// and its load generator. Failures throw std::runtime_error.
+class LocalSocket {
+public:
+    LocalSocket();
+    explicit LocalSocket(int fd);
+    ~LocalSocket();
+
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+
+    static LocalSocket listenAt(const std::string& path);
+    static LocalSocket connectTo(const std::string& path);
+
+    // Returns an invalid socket when no client is waiting
+    LocalSocket accept();
+
+    // Appends whatever is available to buffer; returns false once the peer has closed
+    bool receive(std::string& buffer);
+    // Extracts one '\n'-terminated line from buffer, without the terminator
+    static bool takeLine(std::string& buffer, std::string& line);
+
+    // Sends what the socket takes without blocking and drops it from buffer;
+    // returns true once buffer is empty
+    bool flush(std::string& buffer);
+    // Blocking sockets only
+    void sendAll(const std::string& data);
+    // Blocking request/response for clients
+    std::string request(const std::string& line);
+
+    void setNonBlocking();
+    int getDescriptor() const;
+    bool isValid() const;
+
+private:
+    int fd;
+    std::string pending;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include "terrain.h"
+#include "ring_buffer.h"
+#include "shot_rules.h"
+
+// Headless artillery match: the rules of Game (see ShotRules) without a window,
+// font or menu. Both sides are driven externally through fire().
+class Match {
+public:
+    static constexpr std::size_t SHOT_HISTORY_SIZE = 8;
+
+    struct ShotRecord {
+        int side;
+        float angle;
+        float power;
+        sf::Vector2f impact;
+    };
+
+    struct Status {
+        int side;
+        int turnTimer;
+        bool shooting;
+        int rounds;
+        int wins[2];
+    };
+
+    explicit Match(std::uint32_t seed);
+
+    // Fires for the side whose turn it is; fails while a shell is in flight
+    bool fire(float angle, float power);
+    void step(float deltaSeconds);
+
+    Status getStatus() const;
+    const RingBuffer<ShotRecord, SHOT_HISTORY_SIZE>& getHistory() const;
+    std::size_t getMemoryFootprint() const;
+
+private:
+    Terrain terrain;
+    sf::Vector2f tanks[2];
+    sf::Vector2f projectile;
+    sf::Vector2f projectileVelocity;
+    float shotAngle;
+    float shotPower;
+    bool shooting;
+    int side;
+    int turnTimer;
+    int rounds;
+    int wins[2];
+    RingBuffer<ShotRecord, SHOT_HISTORY_SIZE> history;
+    std::minstd_rand rng;
+
+    void startRound();
+    void endShot();
+    void switchTurn();
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "terrain.h"
+
+// Prepares upcoming rounds (terrain with its mesh, tank placement, first turn) on a
+// background thread so a round reset only has to swap pointers. Terrains from
+// finished rounds can be handed back to be regenerated in place.
+class MatchPreloader {
+public:
+    struct PreparedMatch {
+        std::unique_ptr<Terrain> terrain;
+        sf::Vector2f playerPosition;
+        sf::Vector2f cpuPosition;
+        bool playerFirst;
+    };
+
+    static constexpr std::size_t QUEUE_SIZE = 2;
+
+    MatchPreloader(int worldWidth, int worldHeight);
+    ~MatchPreloader();
+
+    MatchPreloader(const MatchPreloader&) = delete;
+    MatchPreloader& operator=(const MatchPreloader&) = delete;
+
+    // Returns false when nothing is ready yet
+    bool take(PreparedMatch& match);
+    void recycle(std::unique_ptr<Terrain> terrain);
+
+    // Builds a round on the calling thread; used by the worker and as a fallback
+    static void prepare(PreparedMatch& match, int worldWidth, int worldHeight, std::mt19937& rng);
+
+private:
+    int worldWidth;
+    int worldHeight;
+
+    // Ready rounds in a fixed ring, plus spare terrains; guarded by mutex
+    std::mutex mutex;
+    std::condition_variable_any wakeup;
+    std::array<PreparedMatch, QUEUE_SIZE> ready;
+    std::size_t readyHead;
+    std::size_t readyCount;
+    std::vector<std::unique_ptr<Terrain>> spareTerrains;
+
+    std::jthread worker;
+
+    void workerLoop(std::stop_token stopToken);
+};
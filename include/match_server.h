@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "match.h"
+#include "ring_buffer.h"
+#include "work_stealing_scheduler.h"
+#include "local_socket.h"
+
+// Hosts many independent matches in one process. Matches are stepped at a fixed
+// rate on a work-stealing scheduler and driven through a line-based protocol on a
+// local socket:
+//   CREATE <count>              -> OK <firstId> <count>
+//   FIRE <id> <angle> <power>   -> OK | ERR <reason>
+//   STATE <id>                  -> OK side=<0|1> timer=<ticks> shooting=<0|1> rounds=<n> wins=<a>,<b>
+//   STATS                       -> OK matches=<n> bytes_per_match=<n> ... tick_p99_us=<us> ...
+//   QUIT                        -> closes the connection
+class MatchServer {
+public:
+    struct Stats {
+        std::size_t matches;
+        std::size_t totalBytes;
+        std::size_t bytesPerMatch;
+        std::uint64_t ticks;
+        std::uint64_t overruns;
+        std::uint64_t steals;
+        float tickP50;  // Microseconds from a tick's scheduled time to its end
+        float tickP90;
+        float tickP99;
+        float tickMax;
+        float stepNanosPerMatch;
+    };
+
+    explicit MatchServer(unsigned threadCount);
+
+    // Serves the socket and ticks matches until stopRequested becomes true
+    void run(const std::string& socketPath, const std::atomic<bool>& stopRequested);
+    std::string handleCommand(const std::string& line);
+    std::size_t createMatches(std::size_t count);
+    Stats getStats();
+
+private:
+    static constexpr float TICK_SECONDS = 1.0f / 60.0f;
+    static constexpr std::size_t TICK_GRAIN = 64;
+    static constexpr std::size_t LATENCY_SAMPLES = 1024;
+    static constexpr int REPORT_INTERVAL_SECONDS = 5;
+    static constexpr int POLL_TIMEOUT_MS = 100;
+    static constexpr std::size_t MAX_CREATE_COUNT = 100000;
+    static constexpr std::size_t MAX_CLIENT_OUTPUT = 1 << 20;  // Unsent bytes before a client is dropped
+
+    WorkStealingScheduler scheduler;
+
+    // Everything below is guarded by mutex; a tick holds it while matches step, so
+    // nothing slow (such as building matches) may run under it
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Match>> matches;
+    std::uint32_t nextSeed;
+    RingBuffer<float, LATENCY_SAMPLES> tickLatencies;
+    float lastStepMicros;
+    std::size_t lastTickMatches;
+    std::uint64_t ticks;
+    std::uint64_t overruns;
+
+    void tick(std::chrono::steady_clock::time_point scheduled);
+    void serveClients(LocalSocket& listener, std::stop_token stopToken);
+};
@@ -10,6 +10,7 @@ public:
     void draw(sf::RenderWindow& window) const;
     void handleInput(const sf::Vector2f& mousePos);
     void update();
+    void reset();
     bool isItemSelected(int index) const;
     bool wasItemClicked(int index) const;
 
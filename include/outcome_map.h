@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ballistics.h"
+
+// Cached shot outcomes over the full angle (0-180) x power (0-100) grid. Cells are
+// only recomputed when terrain under their trajectory changes or the shooter moves.
+class OutcomeMap {
+public:
+    static constexpr int ANGLE_STEPS = 181;  // One degree per cell
+    static constexpr int POWER_STEPS = 101;  // One power unit per cell
+    static constexpr int CELL_COUNT = ANGLE_STEPS * POWER_STEPS;
+
+    struct Cell {
+        Ballistics::Outcome outcome;
+        bool dirty;
+    };
+
+    explicit OutcomeMap(unsigned workerCount);
+    ~OutcomeMap();
+
+    OutcomeMap(const OutcomeMap&) = delete;
+    OutcomeMap& operator=(const OutcomeMap&) = delete;
+
+    // Invalidates the whole map when the shooter, target or physics change
+    void configure(const Ballistics::Params& params);
+    void invalidateColumns(int first, int last);
+    void invalidateAll();
+
+    // Stops a refresh between chunks once the deadline passes or the generation
+    // counter no longer matches; cells not reached yet stay dirty
+    struct RefreshLimit {
+        std::chrono::steady_clock::time_point deadline;
+        const std::atomic<std::uint64_t>* generation;
+        std::uint64_t expectedGeneration;
+    };
+
+    // Recomputes dirty cells in parallel and returns how many were updated
+    std::size_t refresh(const std::vector<float>& heights);
+    std::size_t refresh(const std::vector<float>& heights, const RefreshLimit& limit);
+
+    const Cell& at(int angleIndex, int powerIndex) const;
+    int bestCell() const;
+    // Clean cell missing by at most maxMiss that lies nearest (angle, power), or -1
+    int closestCell(float angle, float power, float maxMiss) const;
+    std::size_t getDirtyCount() const;
+
+    static float angleAt(int cell) { return static_cast<float>(cell / POWER_STEPS); }
+    static float powerAt(int cell) { return static_cast<float>(cell % POWER_STEPS); }
+
+private:
+    static constexpr int REFRESH_CHUNK = 64;
+
+    Ballistics::Params params;
+    bool configured;
+    std::vector<Cell> cells;
+    std::vector<int> dirtyCells;
+
+    // Refresh job shared with the helper threads
+    const std::vector<float>* refreshHeights;
+    const RefreshLimit* refreshLimit;
+    std::atomic<std::size_t> nextDirty;
+    std::atomic<std::size_t> refreshed;
+    std::mutex mutex;
+    std::condition_variable_any wakeup;
+    std::condition_variable finished;
+    std::uint64_t refreshRound;
+    unsigned busyWorkers;
+
+    std::vector<std::jthread> workers;
+
+    void workerLoop(std::stop_token stopToken);
+    void processDirtyCells();
+    bool isInterrupted() const;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+// Fixed-capacity FIFO that overwrites its oldest element when full
+template <typename T, std::size_t Capacity>
+class RingBuffer {
+public:
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator()
+            : buffer(nullptr)
+            , index(0) {
+        }
+
+        ConstIterator(const RingBuffer* buffer, std::size_t index)
+            : buffer(buffer)
+            , index(index) {
+        }
+
+        const T& operator*() const { return (*buffer)[index]; }
+        const T* operator->() const { return &(*buffer)[index]; }
+        ConstIterator& operator++() { ++index; return *this; }
+        ConstIterator operator++(int) { ConstIterator previous = *this; ++index; return previous; }
+        bool operator==(const ConstIterator& other) const { return index == other.index; }
+        bool operator!=(const ConstIterator& other) const { return index != other.index; }
+
+    private:
+        const RingBuffer* buffer;
+        std::size_t index;
+    };
+
+    void push(const T& value) {
+        items[(head + count) % Capacity] = value;
+        if (count < Capacity) {
+            ++count;
+        } else {
+            head = (head + 1) % Capacity;
+        }
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+    std::size_t size() const { return count; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    // Index 0 is the oldest element
+    const T& operator[](std::size_t index) const { return items[(head + index) % Capacity]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, count); }
+
+private:
+    std::array<T, Capacity> items{};
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Append-only shot history kept in a memory-mapped file, so every shot ever fired
+// survives across rounds and sessions. Shots are stored relative to the shooter and
+// mirrored to face right, so both sides' shots apply to either tank. A fixed grid over
+// (dx, dy, ridge) keeps the best few near-hits per cell, which bounds lookup cost
+// however many shots the file holds. Failures to open throw std::runtime_error. POSIX builds
+// use mmap, Windows builds CreateFileMapping/MapViewOfFile.
+class ShotLog {
+public:
+    static constexpr float SUCCESS_DISTANCE = 50.0f; // Miss distance still worth repeating
+
+    struct Record {
+        float dx;     // Target minus shooter, mirrored so dx >= 0
+        float dy;
+        float ridge;  // See profileSignature
+        float angle;
+        float power;
+        float missX;  // Impact minus target position
+        float missY;
+        std::uint32_t flags;
+    };
+
+    static constexpr std::uint32_t FLAG_HIT = 1;
+
+    ShotLog(float maxDx, float maxDy);
+    ~ShotLog();
+
+    ShotLog(const ShotLog&) = delete;
+    ShotLog& operator=(const ShotLog&) = delete;
+
+    // Maps the file (creating it if needed) and indexes the shots already in it
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    // Both are no-ops / return false while the log is not open
+    void append(sf::Vector2f shooter, sf::Vector2f target, float ridge,
+                float angle, float power, sf::Vector2f impact, bool hit);
+    bool findNearest(sf::Vector2f shooter, sf::Vector2f target, float ridge,
+                     float& angle, float& power) const;
+
+    std::size_t size() const;
+
+    // Terrain profile signature: how far the highest ground between the tanks rises above the shooter
+    static float profileSignature(const std::vector<float>& heights, sf::Vector2f shooter, sf::Vector2f target);
+
+private:
+    static constexpr std::uint32_t MAGIC = 0x474C5453; // "STLG"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t INITIAL_CAPACITY = 4096;
+    static constexpr float CELL_SIZE = 32.0f;
+    static constexpr std::size_t CELL_CAPACITY = 8;
+    static constexpr int MAX_SEARCH_RING = 3;
+
+    // Where a shot was fired from, relative to its target
+    struct Situation {
+        float dx;
+        float dy;
+        float ridge;  // Terrain profile signature: highest ground between the tanks above the shooter
+    };
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint32_t reserved;
+        std::uint64_t count;
+        std::uint64_t padding;
+    };
+
+    // Record indices ordered by miss distance, best first
+    struct Cell {
+        std::array<std::uint32_t, CELL_CAPACITY> records;
+        std::array<float, CELL_CAPACITY> misses;
+        std::size_t count;
+    };
+
+#ifdef _WIN32
+    void* file;         // HANDLE
+    void* fileMapping;  // HANDLE
+#else
+    int fd;
+#endif
+    void* mapping;
+    std::size_t mappedBytes;
+    std::size_t capacity;
+
+    int gridWidth;
+    int gridHeight;
+    int gridDepth;  // Ridge axis, so each terrain profile keeps its own best shots
+    float maxDy;
+    std::vector<Cell> grid;
+
+    Header* header() const;
+    Record* records() const;
+    void remap(std::size_t newCapacity);
+    void load(std::size_t fileBytes, const std::string& path);
+
+    static Situation normalize(sf::Vector2f shooter, sf::Vector2f target, float ridge);
+    int cellIndex(int cellX, int cellY, int cellZ) const;
+    void cellOf(const Situation& situation, int& cellX, int& cellY, int& cellZ) const;
+    void index(std::uint32_t recordIndex);
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "terrain.h"
+
+// The shot rules shared by Game, the headless Match and Ballistics: world size,
+// physics constants, tank placement and one projectile step. Keeping them in one
+// place stops the server and the CPU's simulations drifting from the game.
+namespace ShotRules {
+    constexpr int WORLD_WIDTH = 1600;
+    constexpr int WORLD_HEIGHT = 600;
+    constexpr int TURN_TIME = 600; // 10 seconds at 60 ticks per second
+    constexpr float GRAVITY = 981.0f;
+    constexpr float POWER_MULTIPLIER = 15.0f;
+    constexpr float CRATER_RADIUS = 20.0f;
+    constexpr float TARGET_HALF_SIZE = 25.0f; // Tank half size plus projectile radius
+
+    enum class Result { Flying, HitTerrain, HitTarget, OffWorld };
+
+    struct Placement {
+        sf::Vector2f left;
+        sf::Vector2f right;
+        bool leftFirst;
+    };
+
+    inline sf::Vector2f launchVelocity(float angle, float power, float powerMultiplier = POWER_MULTIPLIER) {
+        float radians = angle * 3.14159f / 180.f;
+        return sf::Vector2f(
+            std::cos(radians) * power * powerMultiplier,
+            -std::sin(radians) * power * powerMultiplier
+        );
+    }
+
+    inline bool hitsTarget(const sf::Vector2f& position, const sf::Vector2f& target) {
+        return std::abs(position.x - target.x) <= TARGET_HALF_SIZE &&
+               std::abs(position.y - target.y) <= TARGET_HALF_SIZE;
+    }
+
+    // Moves the shell one step, then tests terrain, target and world bounds in that order
+    inline Result step(sf::Vector2f& position, sf::Vector2f& velocity, float deltaSeconds,
+                       const std::vector<float>& heights, const sf::Vector2f& target,
+                       float gravity = GRAVITY, int worldHeight = WORLD_HEIGHT) {
+        velocity.y += gravity * deltaSeconds;
+        position += velocity * deltaSeconds;
+
+        const int width = static_cast<int>(heights.size());
+        if (position.x >= 0 && position.x < width && position.y >= heights[static_cast<int>(position.x)]) {
+            return Result::HitTerrain;
+        }
+        if (hitsTarget(position, target)) {
+            return Result::HitTarget;
+        }
+        if (position.x < 0 || position.x > width || position.y > worldHeight) {
+            return Result::OffWorld;
+        }
+        return Result::Flying;
+    }
+
+    // Random tank spots near either edge of a freshly generated terrain, plus who starts
+    template <typename Rng>
+    Placement placeTanks(const Terrain& terrain, int worldWidth, Rng& rng) {
+        std::uniform_real_distribution<float> leftBand(50.f, 200.f);
+        std::uniform_real_distribution<float> rightBand(worldWidth - 200.f, worldWidth - 50.f);
+        float tankX[2] = { leftBand(rng), rightBand(rng) };
+        float tankY[2];
+        terrain.getHeightsAt(tankX, tankY, Terrain::Interpolation::Linear);
+
+        Placement placement;
+        placement.left = sf::Vector2f(tankX[0], tankY[0]);
+        placement.right = sf::Vector2f(tankX[1], tankY[1]);
+        placement.leftFirst = (rng() % 2) == 0;
+        return placement;
+    }
+}
@@ -1,16 +1,69 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 
 class Terrain {
 public:
-    Terrain(int width, int height);
+    enum class MeshMode { Full, Adaptive, None };  // None keeps no vertices (headless)
+
+    static constexpr float DEFAULT_CRATER_DEPTH = 20.0f;
+
+    // The adaptive mesh saves draw and upload work, not memory: its vertex storage is
+    // sized for the full mesh up front and the LOD scratch comes on top
+    struct MeshStats {
+        std::size_t fullVertexCount;  // Vertices a Full mesh draws per frame
+        std::size_t vertexCount;      // Vertices drawn per frame
+        std::size_t fullBytes;        // Memory a Full mesh holds
+        std::size_t heldBytes;        // Memory this mesh holds: vertex storage plus LOD scratch
+    };
+
+    struct ColumnRange {
+        int first;
+        int last;
+    };
+
+    enum class CraterProfile { Linear, Circular, Custom };
+    enum class Interpolation { Nearest, Linear, Cubic };
+
+    struct Impact {
+        sf::Vector2f position;
+        float radius;
+        CraterProfile profile = CraterProfile::Linear;
+        float depth = DEFAULT_CRATER_DEPTH;
+        std::span<const float> kernel;  // Custom profile: depth factors from the left edge (-radius) to the right edge (+radius)
+    };
+
+    Terrain(int width, int height, MeshMode mode = MeshMode::Full);
 
     void generate();
+    void generate(std::uint32_t seed);
     void draw(sf::RenderWindow& window) const;
-    void deform(const sf::Vector2f& impact, float radius);
+    // Submits only the vertices covering world x in [left, right]
+    void draw(sf::RenderWindow& window, float left, float right) const;
+    ColumnRange deform(const sf::Vector2f& impact, float radius);
+    // Applies all impacts in one pass over merged column ranges and updates the mesh once
+    ColumnRange deformBatch(std::span<const Impact> impacts);
     float getHeightAt(float x) const;
+    // Batched lookups; out must be at least as long as xs. Nearest matches getHeightAt.
+    void getHeightsAt(std::span<const float> xs, std::span<float> out,
+                      Interpolation mode = Interpolation::Nearest) const;
+    // Slope is dy/dx in screen space (positive going downhill to the right)
+    void getSlopesAt(std::span<const float> xs, std::span<float> out,
+                     Interpolation mode = Interpolation::Linear) const;
+    // Unit normals pointing out of the ground (towards the sky)
+    void getNormalsAt(std::span<const float> xs, std::span<sf::Vector2f> out,
+                      Interpolation mode = Interpolation::Linear) const;
     bool isCollision(const sf::Vector2f& point) const;
+    const std::vector<float>& getHeights() const;
+
+    // Adaptive mode drops columns that lie within tolerance (in pixels) of the simplified surface
+    void setMeshMode(MeshMode mode, float tolerance = DEFAULT_LOD_TOLERANCE);
+    MeshStats getMeshStats() const;
+    std::size_t getMemoryFootprint() const;
 
 private:
     static constexpr float SMOOTHING = 0.1f;
@@ -20,11 +73,26 @@ private:
     static constexpr float SMOOTHING_FACTOR = 0.2f;
     static constexpr int SMOOTHING_PASSES = 3;
     static constexpr float BASE_HEIGHT_VARIATION = 100.0f;
+    static constexpr float DEFAULT_LOD_TOLERANCE = 0.5f;
+    static constexpr std::size_t NORMAL_BATCH = 256;
+    static constexpr std::size_t MAX_BATCHED_IMPACTS = 64;  // Reserved up front, larger batches grow the scratch
 
     int width;
     int height;
     std::vector<float> heights;
     sf::VertexArray terrain;
+    std::size_t vertexCapacity;  // sf::VertexArray keeps its largest size allocated
+
+    // Adaptive mesh state
+    MeshMode meshMode;
+    float lodTolerance;
+    std::vector<int> meshColumns;              // Kept columns, sorted by x
+    std::vector<int> lodScratch;               // Columns produced by simplifyRange
+    std::vector<std::pair<int, int>> lodStack; // Pending segments for simplifyRange
+
+    // Crater batching scratch
+    std::vector<float> craterDelta;            // Per-column depth, zero outside active ranges; empty for MeshMode::None
+    std::vector<ColumnRange> craterRanges;     // Impact ranges, merged in place
 
     // Add helper methods
     void smoothTerrain();
@@ -32,5 +100,15 @@ private:
     void applyHeightGradient();
 
     void updateVertexArray();
+    void resizeVertices(std::size_t count);
+    void rebuildMesh();
+    void reserveLodScratch();
+    float* craterScratch();
+    void updateMeshRanges(std::span<const ColumnRange> ranges);
+    void resimplifyRange(int start, int end);
+    void simplifyRange(int first, int last);
+    void writeColumn(int vertexIndex, int column);
+    // t is the signed offset from the crater centre in radii, -1 to 1
+    static float sampleKernel(std::span<const float> kernel, float t);
     float smoothNoise(float x) const;
 };
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Blocking parallel-for over index ranges. Each call splits [0, count) into chunks
+// dealt round-robin onto per-worker queues; a worker drains its own queue from the
+// back and steals from the front of the others when it runs dry. The calling
+// thread acts as worker 0.
+class WorkStealingScheduler {
+public:
+    explicit WorkStealingScheduler(unsigned threadCount);
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t grain, Function& function) {
+        run(count, grain, [](void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<Function*>(context))(begin, end);
+        }, &function);
+    }
+
+    unsigned getThreadCount() const;
+    std::uint64_t getStealCount() const;
+
+private:
+    using RangeFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::vector<Range> ranges;
+        std::size_t head = 0;
+        std::size_t tail = 0;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    // Current job, published under mutex
+    std::mutex mutex;
+    std::condition_variable_any wakeup;
+    std::condition_variable finished;
+    RangeFunction jobFunction;
+    void* jobContext;
+    std::uint64_t jobRound;
+    unsigned busyWorkers;
+    std::atomic<std::uint64_t> steals;
+
+    std::vector<std::jthread> workers;
+
+    void run(std::size_t count, std::size_t grain, RangeFunction function, void* context);
+    void workerLoop(unsigned index, std::stop_token stopToken);
+    void drain(unsigned index);
+    bool takeOwn(unsigned index, Range& range);
+    bool steal(unsigned thief, Range& range);
+};
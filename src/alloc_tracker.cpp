@@ -0,0 +1,315 @@
+#include "../include/alloc_tracker.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ARTILLERY_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define ARTILLERY_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+#ifndef NDEBUG
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <dbghelp.h>
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+#endif
+
+namespace {
+    thread_local AllocTracker::Subsystem currentSubsystem = AllocTracker::Subsystem::Other;
+    thread_local bool isFrameThread = false;
+
+    // Written by the frame thread only
+    AllocTracker::Counters frameCounters[AllocTracker::SUBSYSTEM_COUNT];
+
+    // Worker threads (CPU search, outcome map helpers, round preloader)
+    std::atomic<std::size_t> backgroundAllocations{0};
+    std::atomic<std::size_t> backgroundBytes{0};
+
+#ifndef NDEBUG
+    constexpr int MAX_STACK_DEPTH = 24;
+
+    // Open-addressed table keyed by return address, frame thread only; never allocates
+    AllocTracker::CallSite callSites[AllocTracker::MAX_CALL_SITES];
+
+    // Set while a call site is resolved, so the symbol lookups cannot recurse
+    thread_local bool resolvingCallSite = false;
+
+    int captureStack(void** frames, int maxDepth) {
+#ifdef _WIN32
+        return static_cast<int>(::CaptureStackBackTrace(0, static_cast<DWORD>(maxDepth), frames, nullptr));
+#else
+        return ::backtrace(frames, maxDepth);
+#endif
+    }
+
+    // Raw symbol of the function containing address: mangled on POSIX, undecorated on Windows
+    bool symbolName(const void* address, char* name, std::size_t size) {
+#ifdef _WIN32
+        static const bool initialized = ::SymInitialize(::GetCurrentProcess(), nullptr, TRUE) != FALSE;
+        if (!initialized) return false;
+
+        alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + AllocTracker::MAX_FUNCTION_NAME];
+        SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = AllocTracker::MAX_FUNCTION_NAME;
+        DWORD64 displacement = 0;
+        if (!::SymFromAddr(::GetCurrentProcess(), reinterpret_cast<DWORD64>(address), &displacement, symbol)) {
+            return false;
+        }
+        std::strncpy(name, symbol->Name, size - 1);
+#else
+        Dl_info info;
+        if (!::dladdr(address, &info) || !info.dli_sname) return false;
+        std::strncpy(name, info.dli_sname, size - 1);
+#endif
+        name[size - 1] = '\0';
+        return true;
+    }
+
+    // Frames between operator new and the code that asked for memory: containers,
+    // strings, std::allocator and the allocator_traits plumbing
+    bool isLibraryFrame(const char* name) {
+        static const char* const prefixes[] = {
+#ifdef _WIN32
+            "std::", "operator new",
+#else
+            "_ZNSt", "_ZNKSt", "_ZSt", "_ZN9__gnu_cxx", "_ZNK9__gnu_cxx", "_Znw", "_Zna",
+#endif
+        };
+        for (const char* prefix : prefixes) {
+            if (std::strncmp(name, prefix, std::strlen(prefix)) == 0) return true;
+        }
+        return false;
+    }
+
+    // Walks up from operator new's caller to the first frame outside the standard library
+    const void* findUserFrame(const void* callSite) {
+        void* frames[MAX_STACK_DEPTH];
+        int depth = captureStack(frames, MAX_STACK_DEPTH);
+
+        // Everything before operator new's caller is the tracker itself
+        int first = 0;
+        while (first < depth && frames[first] != callSite) {
+            ++first;
+        }
+
+        char name[AllocTracker::MAX_FUNCTION_NAME];
+        for (int i = first; i < depth; ++i) {
+            if (!symbolName(frames[i], name, sizeof(name)) || !isLibraryFrame(name)) {
+                return frames[i];
+            }
+        }
+        return callSite;
+    }
+
+    void describeFrame(const void* address, char* out, std::size_t size) {
+        out[0] = '\0';
+        char name[AllocTracker::MAX_FUNCTION_NAME];
+        if (!symbolName(address, name, sizeof(name))) return;
+#ifdef _WIN32
+        std::strncpy(out, name, size - 1);
+#else
+        // The demangler uses malloc, which the tracker does not see
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        std::strncpy(out, status == 0 && demangled ? demangled : name, size - 1);
+        std::free(demangled);
+#endif
+        out[size - 1] = '\0';
+    }
+
+    void recordCallSite(const void* callSite, std::size_t bytes) {
+        if (resolvingCallSite) return;
+        resolvingCallSite = true;
+
+        const void* address = findUserFrame(callSite);
+        std::size_t hash = reinterpret_cast<std::uintptr_t>(address) >> 4;
+        for (std::size_t probe = 0; probe < AllocTracker::MAX_CALL_SITES; ++probe) {
+            AllocTracker::CallSite& slot = callSites[(hash + probe) % AllocTracker::MAX_CALL_SITES];
+            if (slot.address == nullptr) {
+                slot.address = address;
+                describeFrame(address, slot.function, sizeof(slot.function));
+            }
+            if (slot.address == address) {
+                slot.allocations++;
+                slot.bytes += bytes;
+                break;
+            }
+        }
+        // Table full: the site is still counted in the frame totals
+
+        resolvingCallSite = false;
+    }
+#endif
+}
+
+AllocTracker::Scope::Scope(Subsystem subsystem)
+    : previous(currentSubsystem) {
+    currentSubsystem = subsystem;
+}
+
+AllocTracker::Scope::~Scope() {
+    currentSubsystem = previous;
+}
+
+bool AllocTracker::isEnabled() {
+#ifdef ARTILLERY_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocTracker::beginFrame() {
+    isFrameThread = true;
+    for (auto& counters : frameCounters) {
+        counters = Counters{0, 0};
+    }
+    backgroundAllocations.store(0, std::memory_order_relaxed);
+    backgroundBytes.store(0, std::memory_order_relaxed);
+#ifndef NDEBUG
+    for (auto& site : callSites) {
+        site.address = nullptr;
+        site.function[0] = '\0';
+        site.allocations = 0;
+        site.bytes = 0;
+    }
+#endif
+}
+
+AllocTracker::FrameStats AllocTracker::endFrame() {
+    FrameStats stats{};
+    for (int i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        stats.subsystems[i] = frameCounters[i];
+        stats.total.allocations += frameCounters[i].allocations;
+        stats.total.bytes += frameCounters[i].bytes;
+    }
+    stats.background.allocations = backgroundAllocations.load(std::memory_order_relaxed);
+    stats.background.bytes = backgroundBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* AllocTracker::getSubsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Input: return "input";
+        case Subsystem::Update: return "update";
+        case Subsystem::Render: return "render";
+        default: return "other";
+    }
+}
+
+std::size_t AllocTracker::getCallSites(CallSite* out, std::size_t maxCount) {
+    std::size_t written = 0;
+#ifndef NDEBUG
+    for (const auto& site : callSites) {
+        if (written >= maxCount) break;
+        if (site.address) {
+            out[written++] = site;
+        }
+    }
+#else
+    (void)out;
+    (void)maxCount;
+#endif
+    return written;
+}
+
+void AllocTracker::recordAllocation(std::size_t bytes, const void* callSite) {
+    if (!isFrameThread) {
+        backgroundAllocations.fetch_add(1, std::memory_order_relaxed);
+        backgroundBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return;
+    }
+
+    Counters& counters = frameCounters[static_cast<int>(currentSubsystem)];
+    counters.allocations++;
+    counters.bytes += bytes;
+#ifndef NDEBUG
+    recordCallSite(callSite, bytes);
+#else
+    (void)callSite;
+#endif
+}
+
+#ifdef ARTILLERY_TRACK_ALLOCATIONS
+namespace {
+    void* trackedAlloc(std::size_t size, const void* callSite) {
+        AllocTracker::recordAllocation(size, callSite);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* trackedAlignedAlloc(std::size_t size, std::align_val_t align, const void* callSite) {
+        AllocTracker::recordAllocation(size, callSite);
+        std::size_t alignment = static_cast<std::size_t>(align);
+#if defined(_MSC_VER)
+        return _aligned_malloc(size ? size : 1, alignment);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment
+        std::size_t rounded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, rounded);
+#endif
+    }
+
+    void alignedFree(void* ptr) {
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* ptr = trackedAlloc(size, ARTILLERY_RETURN_ADDRESS())) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = trackedAlloc(size, ARTILLERY_RETURN_ADDRESS())) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAlloc(size, ARTILLERY_RETURN_ADDRESS());
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAlloc(size, ARTILLERY_RETURN_ADDRESS());
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* ptr = trackedAlignedAlloc(size, align, ARTILLERY_RETURN_ADDRESS())) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* ptr = trackedAlignedAlloc(size, align, ARTILLERY_RETURN_ADDRESS())) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { alignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { alignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { alignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { alignedFree(ptr); }
+#endif
@@ -0,0 +1,43 @@
+#include "../include/ballistics.h"
+#include "../include/shot_rules.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float SIMULATION_STEP = 1.0f / 60.0f;
+    constexpr int MAX_SIMULATION_STEPS = 600;
+}
+
+Ballistics::Outcome Ballistics::simulate(const Params& params, const std::vector<float>& heights,
+                                         float angle, float power) {
+    const int width = static_cast<int>(heights.size());
+    sf::Vector2f position = params.shooter;
+    sf::Vector2f velocity = ShotRules::launchVelocity(angle, power, params.powerMultiplier);
+
+    Outcome outcome;
+    outcome.hitTarget = false;
+    outcome.minColumn = outcome.maxColumn = std::clamp(static_cast<int>(position.x), 0, width - 1);
+
+    for (int step = 0; step < MAX_SIMULATION_STEPS; ++step) {
+        ShotRules::Result result = ShotRules::step(position, velocity, SIMULATION_STEP, heights,
+                                                   params.target, params.gravity, params.worldHeight);
+
+        int column = std::clamp(static_cast<int>(position.x), 0, width - 1);
+        outcome.minColumn = std::min(outcome.minColumn, column);
+        outcome.maxColumn = std::max(outcome.maxColumn, column);
+
+        if (result == ShotRules::Result::Flying) continue;
+        outcome.hitTarget = result == ShotRules::Result::HitTarget;
+        break;
+    }
+
+    outcome.impact = position;
+    if (outcome.hitTarget) {
+        outcome.missDistance = 0.0f;
+    } else {
+        float dx = position.x - params.target.x;
+        float dy = position.y - params.target.y;
+        outcome.missDistance = std::sqrt(dx * dx + dy * dy);
+    }
+    return outcome;
+}
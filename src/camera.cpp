@@ -0,0 +1,54 @@
+#include "../include/camera.h"
+#include <algorithm>
+
+Camera::Camera(const sf::Vector2f& viewSize, const sf::Vector2f& worldSize)
+    : viewSize(viewSize)
+    , worldSize(worldSize)
+    , centerX(viewSize.x / 2)
+    , zoom(1.0f) {
+
+    applyView();
+}
+
+void Camera::follow(const sf::Vector2f& target, sf::Time deltaTime) {
+    // Ease towards the target so the view doesn't jump between turns
+    float blend = std::min(1.0f, FOLLOW_SPEED * deltaTime.asSeconds());
+    centerX += (target.x - centerX) * blend;
+    applyView();
+}
+
+void Camera::snapTo(const sf::Vector2f& target) {
+    centerX = target.x;
+    applyView();
+}
+
+void Camera::adjustZoom(float factor) {
+    zoom = std::clamp(zoom * factor, MIN_ZOOM, MAX_ZOOM);
+    applyView();
+}
+
+const sf::View& Camera::getView() const {
+    return view;
+}
+
+sf::FloatRect Camera::getVisibleArea() const {
+    sf::Vector2f size = view.getSize();
+    sf::Vector2f center = view.getCenter();
+    return sf::FloatRect(center.x - size.x / 2, center.y - size.y / 2, size.x, size.y);
+}
+
+void Camera::applyView() {
+    sf::Vector2f size(viewSize.x * zoom, viewSize.y * zoom);
+
+    // Keep the view inside the world horizontally, or centred if it is wider
+    float halfWidth = size.x / 2;
+    if (size.x >= worldSize.x) {
+        centerX = worldSize.x / 2;
+    } else {
+        centerX = std::clamp(centerX, halfWidth, worldSize.x - halfWidth);
+    }
+
+    // Ground stays at the bottom edge; zooming out reveals more sky
+    view.setSize(size);
+    view.setCenter(centerX, worldSize.y - size.y / 2);
+}
@@ -0,0 +1,237 @@
+#include "../include/cpu_ai.h"
+#include <algorithm>
+#include <cmath>
+
+CpuAI::CpuAI(int maxColumns, int worldHeight)
+    : worldHeight(worldHeight)
+    , pendingRequest{}
+    , jobPending(false)
+    , searching(false)
+    , result{}
+    , resultReady(false)
+    , resultGeneration(0)
+    , invalidRanges{}
+    , invalidRangeCount(0)
+    , invalidEverything(false)
+    , heatmap(OutcomeMap::CELL_COUNT, -1.0f)
+    , heatmapVersion(0)
+    , generation(0)
+    , activeRequest{}
+    , outcomeMap(std::max(1u, std::thread::hardware_concurrency()) - 1) {
+
+    // Reserve the terrain snapshots up front so starting a search never allocates
+    pendingHeights.reserve(maxColumns);
+    activeHeights.reserve(maxColumns);
+
+    worker = std::jthread([this](std::stop_token stopToken) { workerLoop(stopToken); });
+}
+
+CpuAI::~CpuAI() {
+    cancel();
+    worker.request_stop();
+}
+
+void CpuAI::start(const Request& request, const std::vector<float>& heights) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingRequest = request;
+    pendingHeights.assign(heights.begin(), heights.end());
+    jobPending = true;
+    resultReady = false;
+    generation.fetch_add(1);
+    wakeup.notify_one();
+}
+
+bool CpuAI::poll(Decision& decision) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!resultReady || resultGeneration != generation.load()) return false;
+
+    decision = result;
+    resultReady = false;
+    return true;
+}
+
+void CpuAI::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobPending = false;
+    resultReady = false;
+    generation.fetch_add(1);
+}
+
+bool CpuAI::isThinking() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobPending || searching;
+}
+
+void CpuAI::invalidateColumns(int first, int last) {
+    if (first > last) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (invalidRangeCount < MAX_QUEUED_RANGES) {
+        invalidRanges[invalidRangeCount++] = ColumnSpan{first, last};
+    } else {
+        // Queue full: widening the last range over-invalidates but stays correct
+        ColumnSpan& span = invalidRanges[MAX_QUEUED_RANGES - 1];
+        span.first = std::min(span.first, first);
+        span.last = std::max(span.last, last);
+    }
+}
+
+void CpuAI::invalidateAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    invalidEverything = true;
+}
+
+bool CpuAI::copyHeatmap(std::vector<float>& out, std::uint64_t& version) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (version == heatmapVersion) return false;
+
+    out.assign(heatmap.begin(), heatmap.end());
+    version = heatmapVersion;
+    return true;
+}
+
+void CpuAI::workerLoop(std::stop_token stopToken) {
+    while (!stopToken.stop_requested()) {
+        std::uint64_t jobGeneration;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!wakeup.wait(lock, stopToken, [this] { return jobPending; })) {
+                return;
+            }
+
+            // Swap keeps both reserved buffers alive, so no allocation happens here
+            activeRequest = pendingRequest;
+            activeHeights.swap(pendingHeights);
+            jobPending = false;
+            searching = true;
+            jobGeneration = generation.load();
+        }
+
+        // The budget covers the map refresh as well as the search
+        auto deadline = std::chrono::steady_clock::now() + activeRequest.budget;
+        refreshOutcomeMap(jobGeneration, deadline);
+        Decision decision = search(jobGeneration, stopToken, deadline);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        searching = false;
+        if (jobGeneration == generation.load()) {
+            result = decision;
+            resultReady = true;
+            resultGeneration = jobGeneration;
+        }
+    }
+}
+
+Ballistics::Params CpuAI::getActiveParams() const {
+    Ballistics::Params params;
+    params.shooter = activeRequest.shooter;
+    params.target = activeRequest.target;
+    params.gravity = activeRequest.gravity;
+    params.powerMultiplier = activeRequest.powerMultiplier;
+    params.worldHeight = worldHeight;
+    return params;
+}
+
+void CpuAI::refreshOutcomeMap(std::uint64_t jobGeneration, std::chrono::steady_clock::time_point deadline) {
+    std::array<ColumnSpan, MAX_QUEUED_RANGES> ranges;
+    std::size_t rangeCount;
+    bool everything;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ranges = invalidRanges;
+        rangeCount = invalidRangeCount;
+        everything = invalidEverything;
+        invalidRangeCount = 0;
+        invalidEverything = false;
+    }
+
+    outcomeMap.configure(getActiveParams());
+    if (everything) {
+        outcomeMap.invalidateAll();
+    } else {
+        for (std::size_t i = 0; i < rangeCount; ++i) {
+            outcomeMap.invalidateColumns(ranges[i].first, ranges[i].last);
+        }
+    }
+
+    OutcomeMap::RefreshLimit limit{deadline, &generation, jobGeneration};
+    if (outcomeMap.refresh(activeHeights, limit) == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < OutcomeMap::CELL_COUNT; ++i) {
+        const auto& cell = outcomeMap.at(i / OutcomeMap::POWER_STEPS, i % OutcomeMap::POWER_STEPS);
+        heatmap[i] = cell.dirty ? -1.0f : cell.outcome.missDistance;
+    }
+    heatmapVersion++;
+}
+
+CpuAI::Decision CpuAI::search(std::uint64_t jobGeneration, std::stop_token stopToken,
+                              std::chrono::steady_clock::time_point deadline) {
+    rng.seed(activeRequest.seed);
+
+    Ballistics::Params params = getActiveParams();
+
+    Decision best;
+    best.angle = std::clamp(activeRequest.seedAngle, 0.0f, 180.0f);
+    best.power = std::clamp(activeRequest.seedPower, 0.0f, 100.0f);
+    best.missDistance = Ballistics::simulate(params, activeHeights, best.angle, best.power).missDistance;
+    best.evaluated = 1;
+    best.completed = false;
+
+    // A shot that worked before replaces the seed unless it now does worse
+    float priorAngle = 0.0f;
+    float priorPower = 0.0f;
+    if (activeRequest.hasPrior) {
+        priorAngle = std::clamp(activeRequest.priorAngle, 0.0f, 180.0f);
+        priorPower = std::clamp(activeRequest.priorPower, 0.0f, 100.0f);
+        float miss = Ballistics::simulate(params, activeHeights, priorAngle, priorPower).missDistance;
+        best.evaluated++;
+        if (miss <= best.missDistance) {
+            best.angle = priorAngle;
+            best.power = priorPower;
+            best.missDistance = miss;
+        }
+    }
+
+    // Start from the best cell the (possibly partial) refresh left clean. Many cells
+    // usually tie (every direct hit scores 0), so the prior picks the one nearest to it.
+    int cell = outcomeMap.bestCell();
+    if (cell >= 0 && activeRequest.hasPrior) {
+        float bestMiss = outcomeMap.at(cell / OutcomeMap::POWER_STEPS, cell % OutcomeMap::POWER_STEPS).outcome.missDistance;
+        cell = outcomeMap.closestCell(priorAngle, priorPower, bestMiss);
+    }
+    if (cell >= 0) {
+        const auto& outcome = outcomeMap.at(cell / OutcomeMap::POWER_STEPS, cell % OutcomeMap::POWER_STEPS).outcome;
+        if (outcome.missDistance < best.missDistance) {
+            best.angle = OutcomeMap::angleAt(cell);
+            best.power = OutcomeMap::powerAt(cell);
+            best.missDistance = outcome.missDistance;
+        }
+    }
+
+    auto keepGoing = [&]() {
+        return best.missDistance > 0.0f &&
+               generation.load(std::memory_order_relaxed) == jobGeneration &&
+               !stopToken.stop_requested() &&
+               std::chrono::steady_clock::now() < deadline;
+    };
+
+    // Random local refinement around the best shot until the budget runs out
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    float scale = 1.0f;
+    while (keepGoing()) {
+        float angle = std::clamp(best.angle + offset(rng) * REFINE_ANGLE_RANGE * scale, 0.0f, 180.0f);
+        float power = std::clamp(best.power + offset(rng) * REFINE_POWER_RANGE * scale, 0.0f, 100.0f);
+        float miss = Ballistics::simulate(params, activeHeights, angle, power).missDistance;
+        best.evaluated++;
+        if (miss < best.missDistance) {
+            best.angle = angle;
+            best.power = power;
+            best.missDistance = miss;
+        }
+        scale = std::max(0.05f, scale * 0.99f);
+    }
+
+    best.completed = best.missDistance <= 0.0f;
+    return best;
+}
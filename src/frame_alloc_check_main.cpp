@@ -0,0 +1,156 @@
+#include "../include/alloc_tracker.h"
+#include "../include/game_session.h"
+#include "../include/shot_log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Headless steady-state frame check, run by ctest in ARTILLERY_TRACK_ALLOCATIONS
+// builds. Plays GameSession, the per-frame logic Game runs between polling the
+// window and drawing, with a scripted player: the same input and update calls
+// Game makes, the CPU search, the shot log lookups and appends, craters and new
+// rounds. Fails on any frame-thread allocation after warm-up. Window events and
+// rendering need a display and a GL context and are not covered.
+namespace {
+    constexpr float FRAME_SECONDS = 1.0f / 60.0f;
+    constexpr int WARMUP_FRAMES = 60;
+    constexpr int DEFAULT_CHECKED_FRAMES = 3000;
+    constexpr const char* SHOT_LOG_PATH = "frame_alloc_check_log.bin";
+
+    // Leaves a few free records so the check also covers the log growing its mapping
+    void prefillShotLog(const std::string& path) {
+        std::remove(path.c_str());
+        ShotLog log(GameSession::WORLD_WIDTH, GameSession::WORLD_HEIGHT);
+        log.open(path);
+        for (int i = 0; i < 4090; ++i) {
+            sf::Vector2f shooter(100.f + i % 100, 400.f);
+            sf::Vector2f target(1500.f - i % 100, 420.f);
+            log.append(shooter, target, 0.0f, 40.f + i % 20, 50.f + i % 40, target + sf::Vector2f(i % 80, 0.f), false);
+        }
+    }
+
+    // Holds space for a while, nudging the barrel, then lets go, like a player would
+    class ScriptedPlayer {
+    public:
+        void play(GameSession& session) {
+            if (!session.canPlayerAct()) {
+                session.updatePowerMeter(false);
+                return;
+            }
+            if (heldFrames == 0) {
+                chargeFrames = 30 + static_cast<int>(next() % 60);
+                session.adjustPlayerAngle(next() % 2 ? 1.0f : -1.0f);
+            }
+            if (heldFrames < chargeFrames) {
+                session.updatePowerMeter(true);
+                heldFrames++;
+            } else {
+                session.releaseShot();
+                heldFrames = 0;
+            }
+        }
+
+    private:
+        std::uint32_t state = 1;
+        int heldFrames = 0;
+        int chargeFrames = 0;
+
+        std::uint32_t next() {
+            state = state * 1664525u + 1013904223u;
+            return state >> 16;
+        }
+    };
+}
+
+// Usage: ArtilleryFrameAllocCheck [frames]
+int main(int argc, char* argv[]) {
+    if (!AllocTracker::isEnabled()) {
+        std::cerr << "Build with -DARTILLERY_TRACK_ALLOCATIONS=ON to run this check" << std::endl;
+        return 1;
+    }
+    int checkedFrames = argc > 1 ? std::atoi(argv[1]) : DEFAULT_CHECKED_FRAMES;
+
+    try {
+        prefillShotLog(SHOT_LOG_PATH);
+        std::size_t failedFrames = 0;
+        int rounds = 1;
+        std::size_t loggedBefore;
+        std::size_t loggedAfter;
+        {
+            GameSession session(sf::Vector2f(800.f, 600.f), 1, SHOT_LOG_PATH);
+            session.reset();
+            loggedBefore = session.getShotLogSize();
+
+            ScriptedPlayer player;
+            sf::Time frameTime = sf::seconds(FRAME_SECONDS);
+            int warmupLeft = WARMUP_FRAMES;
+            int checked = 0;
+
+            while (checked < checkedFrames) {
+                AllocTracker::beginFrame();
+                GameSession::Event event;
+                {
+                    AllocTracker::Scope scope(AllocTracker::Subsystem::Input);
+                    player.play(session);
+                }
+                {
+                    AllocTracker::Scope scope(AllocTracker::Subsystem::Update);
+                    event = session.update(frameTime);
+                }
+                AllocTracker::FrameStats stats = AllocTracker::endFrame();
+
+                // Leave the worker some time, as the real frame loop would
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                // A new round may allocate, as in Game; restart the warm-up
+                if (event == GameSession::Event::RoundOver) {
+                    session.reset();
+                    rounds++;
+                    warmupLeft = WARMUP_FRAMES;
+                    continue;
+                }
+                if (warmupLeft > 0) {
+                    warmupLeft--;
+                    continue;
+                }
+                checked++;
+                if (stats.total.allocations == 0) continue;
+
+                failedFrames++;
+                std::cerr << "Frame allocated " << stats.total.allocations
+                          << " times (" << stats.total.bytes << " bytes)" << std::endl;
+                for (int i = 0; i < AllocTracker::SUBSYSTEM_COUNT; ++i) {
+                    const auto& counters = stats.subsystems[i];
+                    if (counters.allocations == 0) continue;
+                    std::cerr << "  " << AllocTracker::getSubsystemName(static_cast<AllocTracker::Subsystem>(i))
+                              << ": " << counters.allocations << " allocations" << std::endl;
+                }
+                AllocTracker::CallSite sites[AllocTracker::MAX_CALL_SITES];
+                std::size_t siteCount = AllocTracker::getCallSites(sites, AllocTracker::MAX_CALL_SITES);
+                for (std::size_t i = 0; i < siteCount; ++i) {
+                    std::cerr << "  call site " << sites[i].address << " " << sites[i].function << ": "
+                              << sites[i].allocations << " allocations, "
+                              << sites[i].bytes << " bytes" << std::endl;
+                }
+            }
+            loggedAfter = session.getShotLogSize();
+        }
+        std::remove(SHOT_LOG_PATH);
+
+        std::cout << checkedFrames << " steady-state frames over " << rounds << " round(s), "
+                  << (loggedAfter - loggedBefore) << " shots logged" << std::endl;
+        if (failedFrames > 0) {
+            std::cerr << failedFrames << " of " << checkedFrames << " steady-state frames allocated" << std::endl;
+            return 1;
+        }
+        std::cout << "No steady-state frame allocated" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
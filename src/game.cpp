@@ -1,53 +1,31 @@
 #include "../include/game.h"
+#include <algorithm>
 #include <cmath>
+#include <iostream>
 
 Game::Game()
     : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Artillery Game")
     , isRunning(true)
     , currentState(GameState::Menu)
-    , isShooting(false)
-    , power(0.0f)
-    , powerDirection(1.0f)
-    , turnTimer(TURN_TIME)
-    , playerTurn(true)
-    , lastPlayerPower(0.0f)
-    , rng(rd()) {
+    , displayedSeconds(-1)
+    , session(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT), std::random_device{}(), SHOT_LOG_PATH)
+    , steadyFrames(0)
+    , allocatingFrames(0)
+    , showOutcomeOverlay(false)
+    , heatmapValues(OutcomeMap::CELL_COUNT, -1.0f)
+    , heatmapVersion(0)
+    , heatmapPixels(OutcomeMap::CELL_COUNT * 4, 0) {
 
     window.setFramerateLimit(60);
-    initializeGame();
-}
 
-void Game::initializeGame() {
-    // Initialize menu
+    // Objects that outlive a round are built once; rounds only reset them
     menu = std::make_unique<Menu>(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+    entityIndex.reserve(2);
 
-    // Initialize terrain
-    terrain = std::make_unique<Terrain>(WINDOW_WIDTH, WINDOW_HEIGHT);
-    terrain->generate();
-
-    // Initialize tanks with random positions
-    float playerX = generateRandomFloat(50.f, 200.f);
-    float cpuX = generateRandomFloat(WINDOW_WIDTH - 200.f, WINDOW_WIDTH - 50.f);
-
-    playerTank = std::make_unique<Tank>(
-        sf::Vector2f(playerX, terrain->getHeightAt(playerX)),
-        45.f,
-        false
-    );
-
-    cpuTank = std::make_unique<Tank>(
-        sf::Vector2f(cpuX, terrain->getHeightAt(cpuX)),
-        135.f,
-        true
-    );
-
-    // Initialize projectile and reset projectile state
+    // Initialize projectile
     projectile.setRadius(5.f);
     projectile.setFillColor(sf::Color::Red);
     projectile.setOrigin(5.f, 5.f);
-    projectile.setPosition(-100.f, -100.f); // Move projectile off-screen
-    projectileVelocity = sf::Vector2f(0.f, 0.f);
-    isShooting = false;
 
     // Load font for timer
     if (!gameFont.loadFromFile("resources/fonts/arial.ttf")) {
@@ -60,15 +38,58 @@ void Game::initializeGame() {
     timerText.setFillColor(sf::Color::White);
     timerText.setPosition(WINDOW_WIDTH / 2 - 50, 10);
 
-    // Randomize first turn
-    playerTurn = (generateRandomInt(0, 1) == 0);
-    turnTimer = TURN_TIME;
-    currentShootingTank = nullptr;
+    // sf::Font rasterizes glyphs on first use; load every glyph the HUD can show
+    // now so a new digit or debug line never allocates mid-round
+    for (char c = '0'; c <= '9'; ++c) {
+        gameFont.getGlyph(static_cast<sf::Uint32>(c), timerText.getCharacterSize(), false);
+    }
+    for (char c = ' '; c <= '~'; ++c) {
+        gameFont.getGlyph(static_cast<sf::Uint32>(c), DEBUG_TEXT_SIZE, false);
+    }
+
+    // Setup debug text, shown with the outcome overlay
+    debugText.setFont(gameFont);
+    debugText.setCharacterSize(DEBUG_TEXT_SIZE);
+    debugText.setFillColor(sf::Color::White);
+    debugText.setPosition(10, 45);
+
+    // Setup power meter
+    powerMeterBackground.setSize(sf::Vector2f(200, 20));
+    powerMeterBackground.setPosition(10, 10);
+    powerMeterBackground.setFillColor(sf::Color(50, 50, 50));
+
+    powerMeterFill.setPosition(10, 10);
+    powerMeterFill.setFillColor(sf::Color::Red);
+
+    previousPowerMarker.setSize(sf::Vector2f(2, 25));
+    previousPowerMarker.setFillColor(sf::Color::Yellow);
+
+    // Heatmap overlay: angle along x, power along y (higher power at the top)
+    heatmapTexture.create(OutcomeMap::ANGLE_STEPS, OutcomeMap::POWER_STEPS);
+    heatmapSprite.setTexture(heatmapTexture);
+    heatmapSprite.setPosition(WINDOW_WIDTH - OutcomeMap::ANGLE_STEPS - 10, 50);
 
-    // Reset power settings
-    power = 0.0f;
-    powerDirection = 1.0f;
-    lastPlayerPower = 0.0f;
+    initializeGame();
+}
+
+void Game::initializeGame() {
+    // Return to a fresh menu
+    menu->reset();
+
+    session.reset();
+
+    // Tanks never move during a round, so the index is built once
+    entityIndex.clear();
+    entityIndex.push_back(EntityEntry{session.getPlayerTank().getPosition().x, &session.getPlayerTank()});
+    entityIndex.push_back(EntityEntry{session.getCpuTank().getPosition().x, &session.getCpuTank()});
+    std::sort(entityIndex.begin(), entityIndex.end(),
+              [](const EntityEntry& a, const EntityEntry& b) { return a.x < b.x; });
+
+    displayedSeconds = -1;
+    refreshDebugText();
+
+    // A new round may allocate; restart the steady-state window
+    steadyFrames = 0;
 }
 
 void Game::run() {
@@ -77,15 +98,59 @@ void Game::run() {
     while (isRunning && window.isOpen()) {
         sf::Time deltaTime = clock.restart();
 
-        handleInput();
-        update(deltaTime);
-        render();
+        AllocTracker::beginFrame();
+        {
+            AllocTracker::Scope scope(AllocTracker::Subsystem::Input);
+            handleInput();
+        }
+        {
+            AllocTracker::Scope scope(AllocTracker::Subsystem::Update);
+            update(deltaTime);
+        }
+        {
+            AllocTracker::Scope scope(AllocTracker::Subsystem::Render);
+            render();
+        }
+        checkFrameAllocations(AllocTracker::endFrame());
     }
 }
 
-void Game::handleInput() {
-    static bool wasSpacePressed = false; // Track previous space state
+void Game::checkFrameAllocations(const AllocTracker::FrameStats& stats) {
+    if (!AllocTracker::isEnabled()) return;
 
+    // Frames after warm-up must not touch the heap. Worker threads are excluded
+    // by the tracker; the F3 overlay formats text and is excluded here.
+    if (steadyFrames < ALLOCATION_WARMUP_FRAMES) {
+        steadyFrames++;
+        return;
+    }
+    if (stats.total.allocations == 0 || showOutcomeOverlay) return;
+
+    std::cerr << "Steady-state frame allocated " << stats.total.allocations
+              << " times (" << stats.total.bytes << " bytes)" << std::endl;
+    for (int i = 0; i < AllocTracker::SUBSYSTEM_COUNT; ++i) {
+        const auto& counters = stats.subsystems[i];
+        if (counters.allocations == 0) continue;
+        std::cerr << "  " << AllocTracker::getSubsystemName(static_cast<AllocTracker::Subsystem>(i))
+                  << ": " << counters.allocations << " allocations, "
+                  << counters.bytes << " bytes" << std::endl;
+    }
+
+    AllocTracker::CallSite sites[AllocTracker::MAX_CALL_SITES];
+    std::size_t siteCount = AllocTracker::getCallSites(sites, AllocTracker::MAX_CALL_SITES);
+    for (std::size_t i = 0; i < siteCount; ++i) {
+        std::cerr << "  call site " << sites[i].address << " " << sites[i].function << ": "
+                  << sites[i].allocations << " allocations, "
+                  << sites[i].bytes << " bytes" << std::endl;
+    }
+
+    // Only reported: SFML's own event queue may allocate under heavy input. The
+    // pass/fail rule lives in the frame_allocations test, which drives GameSession.
+    allocatingFrames++;
+    std::cerr << "  " << allocatingFrames << " allocating frames so far" << std::endl;
+}
+
+void Game::handleInput() {
     sf::Event event;
     while (window.pollEvent(event)) {
         if (event.type == sf::Event::Closed) {
@@ -107,225 +172,61 @@ void Game::handleInput() {
             }
         }
         else {
-            if (playerTurn && !isShooting) {
-                if (event.type == sf::Event::KeyPressed) {
-                    switch (event.key.code) {
-                        case sf::Keyboard::Up:
-                            playerTank->adjustAngle(1.0f);
-                            break;
-                        case sf::Keyboard::Down:
-                            playerTank->adjustAngle(-1.0f);
-                            break;
-                    }
-                }
-
-                // Handle shot on space release
-                if (event.type == sf::Event::KeyReleased &&
-                    event.key.code == sf::Keyboard::Space) {
-                    lastPlayerPower = power;  // Store the power used
-                    shoot(*playerTank);
-                    wasSpacePressed = false;
+            if (event.type == sf::Event::KeyPressed) {
+                switch (event.key.code) {
+                    case sf::Keyboard::F3:
+                        showOutcomeOverlay = !showOutcomeOverlay;
+                        if (showOutcomeOverlay) refreshDebugText();
+                        break;
+                    case sf::Keyboard::Add:
+                    case sf::Keyboard::Equal:
+                        session.getCamera().adjustZoom(1.0f / ZOOM_STEP);
+                        break;
+                    case sf::Keyboard::Subtract:
+                    case sf::Keyboard::Hyphen:
+                        session.getCamera().adjustZoom(ZOOM_STEP);
+                        break;
+                    case sf::Keyboard::Up:
+                        session.adjustPlayerAngle(1.0f);
+                        break;
+                    case sf::Keyboard::Down:
+                        session.adjustPlayerAngle(-1.0f);
+                        break;
+                    default:
+                        break;
                 }
             }
-        }
-    }
-
-    // Handle power meter
-    if (playerTurn && !isShooting) {
-        bool isSpacePressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
-
-        // Reset power only when space is first pressed
-        if (isSpacePressed && !wasSpacePressed) {
-            power = 0.0f;
-            powerDirection = 1.0f;
-        }
 
-        // Update power while space is held
-        if (isSpacePressed) {
-            power += POWER_SPEED * powerDirection;
-
-            // Reverse direction at limits
-            if (power >= 100.0f) {
-                power = 100.0f;
-                powerDirection = -1.0f;
-            } else if (power <= 0.0f) {
-                power = 0.0f;
-                powerDirection = 1.0f;
+            // Scrolling up zooms in
+            if (event.type == sf::Event::MouseWheelScrolled) {
+                session.getCamera().adjustZoom(event.mouseWheelScroll.delta > 0 ? 1.0f / ZOOM_STEP : ZOOM_STEP);
             }
-        }
-
-        wasSpacePressed = isSpacePressed;
-    }
-}
-
-void Game::update(sf::Time deltaTime) {
-    if (currentState != GameState::Playing) return;
-
-    if (isShooting) {
-        updateProjectile(deltaTime);
-        checkCollisions();
-    }
-
-    if (playerTurn) {
-        turnTimer--;
-        if (turnTimer <= 0) {
-            switchTurn();
-        }
-    }
-    else {
-        handleCPUTurn();
-    }
-}
-
-void Game::updateProjectile(sf::Time deltaTime) {
-    projectileVelocity.y += GRAVITY * deltaTime.asSeconds();
-    sf::Vector2f pos = projectile.getPosition();
-    pos += projectileVelocity * deltaTime.asSeconds();
-    projectile.setPosition(pos);
-}
 
-void Game::checkCollisions() {
-    sf::Vector2f pos = projectile.getPosition();
-
-    // Check terrain collision
-    if (terrain->isCollision(pos)) {
-        if (!playerTurn) {
-            // Record CPU shot data
-            sf::Vector2f playerPos = playerTank->getPosition();
-            float distance = std::sqrt(
-                std::pow(pos.x - playerPos.x, 2) +
-                std::pow(pos.y - playerPos.y, 2)
-            );
-
-            ShotData shot;
-            shot.angle = cpuTank->getAngle();
-            shot.power = power;
-            shot.impactPoint = pos;
-            shot.wasClose = distance < 50.f; // Consider shots within 100 pixels "close"
-
-            previousShots.push_back(shot);
-            if (previousShots.size() > 3) {
-                previousShots.erase(previousShots.begin());
+            // Handle shot on space release
+            if (event.type == sf::Event::KeyReleased &&
+                event.key.code == sf::Keyboard::Space) {
+                session.releaseShot();
             }
         }
-
-        terrain->deform(pos, 20.f);
-        isShooting = false;
-        currentShootingTank = nullptr;
-        switchTurn();
-        return;
-    }
-
-    // Check tank collisions, excluding the shooting tank
-    Tank* targetTank = (currentShootingTank == playerTank.get()) ? cpuTank.get() : playerTank.get();
-    if (projectile.getGlobalBounds().intersects(targetTank->getBounds())) {
-        currentState = GameState::Menu;
-        initializeGame();
-        return;
-    }
-
-    // Check if projectile is off-screen
-    if (pos.x < 0 || pos.x > WINDOW_WIDTH || pos.y > WINDOW_HEIGHT) {
-        isShooting = false;
-        currentShootingTank = nullptr;
-        switchTurn();
     }
-}
-
-void Game::shoot(const Tank& tank) {
-    projectile.setPosition(tank.getPosition());
-    float radians = tank.getAngle() * 3.14159f / 180.f;
-
-    float powerMultiplier = 15.0f;
-    projectileVelocity = sf::Vector2f(
-        std::cos(radians) * power * powerMultiplier,
-        -std::sin(radians) * power * powerMultiplier
-    );
 
-    isShooting = true;
-    currentShootingTank = (playerTurn ? playerTank.get() : cpuTank.get());
+    // Handle power meter
+    session.updatePowerMeter(sf::Keyboard::isKeyPressed(sf::Keyboard::Space));
 }
 
-void Game::handleCPUTurn() {
-    if (turnTimer == TURN_TIME - 10) {
-        float targetAngle, targetPower;
-        sf::Vector2f playerPos = playerTank->getPosition();
-        sf::Vector2f cpuPos = cpuTank->getPosition();
-
-        // Calculate distance and height difference
-        float distanceX = playerPos.x - cpuPos.x;
-        float distanceY = playerPos.y - cpuPos.y;
-        float directDistance = std::sqrt(distanceX * distanceX + distanceY * distanceY);
-
-        // Initial shot or reset strategy
-        if (previousShots.empty()) {
-            // Randomly choose between direct or high arc for initial shot
-            bool useHighArc = (generateRandomInt(0, 1) == 1);
-
-            if (useHighArc) {
-                targetAngle = generateRandomFloat(140.0f, 180.0f);  // High arc
-                targetPower = directDistance / 5.0f;  // More power for high arc
-            } else {
-                targetAngle = generateRandomFloat(0.0f, 140.0f);  // Direct shot
-                targetPower = directDistance / 8.0f;  // Less power for direct shot
-            }
-        } else {
-            const auto& lastShot = previousShots.back();
-
-            if (lastShot.impactPoint.x < playerPos.x) {
-                // Hit terrain or fell short - try higher arc
-                if (lastShot.angle < 145.0f) {
-                    // Current angle too low, switch to high arc strategy
-                    targetAngle = generateRandomFloat(150.0f, 165.0f);
-                    targetPower = lastShot.power + 15.0f;
-                } else {
-                    // Already using high arc, increase both
-                    targetAngle = lastShot.angle + 5.0f;
-                    targetPower = lastShot.power + 10.0f;
-                }
-            } else {
-                // Overshot the target
-                if (lastShot.impactPoint.y < playerPos.y) {
-                    // Too high, reduce angle but maintain arc strategy
-                    targetAngle = lastShot.angle - 5.0f;
-                    targetPower = lastShot.power - 5.0f;
-                } else {
-                    // Too far but good height, reduce power
-                    targetAngle = lastShot.angle;
-                    targetPower = lastShot.power - 10.0f;
-                }
-            }
-
-            // Occasionally try completely different approach if missing repeatedly
-            if (previousShots.size() >= 3) {
-                bool allShortShots = true;
-                for (const auto& shot : previousShots) {
-                    if (shot.impactPoint.x >= playerPos.x) {
-                        allShortShots = false;
-                        break;
-                    }
-                }
-
-                if (allShortShots) {
-                    // Switch to high arc strategy
-                    targetAngle = generateRandomFloat(150.0f, 165.0f);
-                    targetPower = directDistance / 5.0f;
-                }
-            }
-        }
-
-        // Add small random variations to prevent getting stuck
-        targetAngle += generateRandomFloat(-2.0f, 2.0f);
-        targetPower += generateRandomFloat(-3.0f, 3.0f);
-
-        cpuTank->setAngle(targetAngle);
-        power = targetPower;
-        shoot(*cpuTank);
-    }
+void Game::update(sf::Time deltaTime) {
+    if (currentState != GameState::Playing) return;
 
-    turnTimer--;
-    if (turnTimer <= 0) {
-        switchTurn();
+    switch (session.update(deltaTime)) {
+        case GameSession::Event::Crater:
+            if (showOutcomeOverlay) refreshDebugText();
+            break;
+        case GameSession::Event::RoundOver:
+            currentState = GameState::Menu;
+            initializeGame();
+            break;
+        case GameSession::Event::None:
+            break;
     }
 }
 
@@ -336,61 +237,104 @@ void Game::render() {
         menu->draw(window);
     }
     else {
-        terrain->draw(window);
-        playerTank->draw(window);
-        cpuTank->draw(window);
-
-        if (isShooting) {
-            window.draw(projectile);
+        // World pass: only what the camera can see
+        Camera& camera = session.getCamera();
+        window.setView(camera.getView());
+        sf::FloatRect visible = camera.getVisibleArea();
+        session.getTerrain().draw(window, visible.left, visible.left + visible.width);
+        drawVisibleEntities(visible);
+
+        if (session.isShooting()) {
+            sf::Vector2f pos = session.getShellPosition();
+            projectile.setPosition(pos);
+            if (pos.x >= visible.left - CULL_MARGIN && pos.x <= visible.left + visible.width + CULL_MARGIN) {
+                window.draw(projectile);
+            }
         }
 
+        // HUD pass in window coordinates
+        window.setView(window.getDefaultView());
+
         // Draw power meter when charging
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space) &&
-            !isShooting && playerTurn) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space) && session.canPlayerAct()) {
             // Draw the power meter background
-            sf::RectangleShape powerMeter(sf::Vector2f(200, 20));
-            powerMeter.setPosition(10, 10);
-            powerMeter.setFillColor(sf::Color(50, 50, 50));
-            window.draw(powerMeter);
+            window.draw(powerMeterBackground);
 
             // Draw the current power level
-            sf::RectangleShape currentPower(sf::Vector2f(power * 2, 20));
-            currentPower.setPosition(10, 10);
-            currentPower.setFillColor(sf::Color::Red);
-            window.draw(currentPower);
+            powerMeterFill.setSize(sf::Vector2f(session.getPower() * 2, 20));
+            window.draw(powerMeterFill);
 
             // Draw the previous power indicator line
+            float lastPlayerPower = session.getLastPlayerPower();
             if (lastPlayerPower > 0) {
-                sf::RectangleShape previousPower(sf::Vector2f(2, 25));
-                previousPower.setPosition(10 + (lastPlayerPower * 2), 7.5f);
-                previousPower.setFillColor(sf::Color::Yellow);
-                window.draw(previousPower);
+                previousPowerMarker.setPosition(10 + (lastPlayerPower * 2), 7.5f);
+                window.draw(previousPowerMarker);
             }
         }
 
-        // Update and draw timer
-        int seconds = turnTimer / 60;
-        timerText.setString(std::to_string(seconds));
+        if (showOutcomeOverlay) {
+            updateOutcomeOverlay();
+            window.draw(heatmapSprite);
+            window.draw(debugText);
+        }
+
+        // Update and draw timer, rebuilding the string only when it changes
+        int seconds = session.getTurnTimer() / 60;
+        if (seconds != displayedSeconds) {
+            timerText.setString(std::to_string(seconds));
+            displayedSeconds = seconds;
+        }
         window.draw(timerText);
     }
 
     window.display();
 }
 
-void Game::switchTurn() {
-    playerTurn = !playerTurn;
-    turnTimer = TURN_TIME;
-    currentShootingTank = nullptr;
-    power = 0.0f;
-    powerDirection = 1.0f;
+void Game::refreshDebugText() {
+    // Only rebuilt when something shown changes, never every frame
+    Terrain::MeshStats mesh = session.getTerrain().getMeshStats();
+    debugText.setString(
+        "reset: " + std::to_string(session.getLastResetMicros()) + " us" +
+        (session.wasLastResetPreloaded() ? " (preloaded)" : " (built in frame)") +
+        "\nmesh: " + std::to_string(mesh.vertexCount) + " / " + std::to_string(mesh.fullVertexCount) +
+        " vertices drawn, " + std::to_string(mesh.heldBytes / 1024) + " KB held (full: " +
+        std::to_string(mesh.fullBytes / 1024) + " KB)" +
+        "\nshots logged: " + std::to_string(session.getShotLogSize()));
 }
 
-float Game::generateRandomFloat(float min, float max) {
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+void Game::drawVisibleEntities(const sf::FloatRect& visible) {
+    float left = visible.left - CULL_MARGIN;
+    float right = visible.left + visible.width + CULL_MARGIN;
+
+    auto it = std::lower_bound(entityIndex.begin(), entityIndex.end(), left,
+                               [](const EntityEntry& entry, float x) { return entry.x < x; });
+    for (; it != entityIndex.end() && it->x <= right; ++it) {
+        it->tank->draw(window);
+    }
 }
 
-int Game::generateRandomInt(int min, int max) {
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(rng);
+void Game::updateOutcomeOverlay() {
+    if (!session.copyHeatmap(heatmapValues, heatmapVersion)) return;
+
+    for (int angle = 0; angle < OutcomeMap::ANGLE_STEPS; ++angle) {
+        for (int power = 0; power < OutcomeMap::POWER_STEPS; ++power) {
+            float miss = heatmapValues[angle * OutcomeMap::POWER_STEPS + power];
+            int row = OutcomeMap::POWER_STEPS - 1 - power;
+            sf::Uint8* pixel = &heatmapPixels[(row * OutcomeMap::ANGLE_STEPS + angle) * 4];
+
+            if (miss < 0.0f) {
+                // Not computed yet
+                pixel[0] = pixel[1] = pixel[2] = 60;
+            } else {
+                // Green for hits fading to red at 400 pixels off
+                float t = std::min(miss / 400.0f, 1.0f);
+                pixel[0] = static_cast<sf::Uint8>(255 * t);
+                pixel[1] = static_cast<sf::Uint8>(255 * (1.0f - t));
+                pixel[2] = 0;
+            }
+            pixel[3] = 200;
+        }
+    }
+
+    heatmapTexture.update(heatmapPixels.data());
 }
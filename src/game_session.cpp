@@ -0,0 +1,404 @@
+#include "../include/game_session.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+GameSession::GameSession(const sf::Vector2f& viewSize, std::uint32_t seed, const std::string& shotLogPath)
+    : camera(viewSize, sf::Vector2f(WORLD_WIDTH, WORLD_HEIGHT))
+    , shooting(false)
+    , shotAngle(0.0f)
+    , shotPower(0.0f)
+    , shotRidge(0.0f)
+    , shotLog(WORLD_WIDTH, WORLD_HEIGHT)
+    , power(0.0f)
+    , powerDirection(1.0f)
+    , lastPlayerPower(0.0f)
+    , wasSpacePressed(false)
+    , turnTimer(TURN_TIME)
+    , playerTurn(true)
+    , rng(seed)
+    , cpuAI(WORLD_WIDTH, WORLD_HEIGHT)
+    , cpuDecisionPending(false)
+    , preloader(WORLD_WIDTH, WORLD_HEIGHT)
+    , lastResetMicros(0)
+    , lastResetPreloaded(false) {
+
+    // Objects that outlive a round are built once; rounds only reset them
+    playerTank = std::make_unique<Tank>(sf::Vector2f(0.f, 0.f), 45.f, false);
+    cpuTank = std::make_unique<Tank>(sf::Vector2f(0.f, 0.f), 135.f, true);
+
+    // The game still works without its shot history, just with a less informed CPU
+    try {
+        shotLog.open(shotLogPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Shot log disabled: " << e.what() << std::endl;
+    }
+}
+
+void GameSession::reset() {
+    sf::Clock resetClock;
+
+    // Swap in a round prepared in the background, or build one now if none is ready
+    MatchPreloader::PreparedMatch next;
+    bool preloaded = preloader.take(next);
+    if (!preloaded) {
+        MatchPreloader::prepare(next, WORLD_WIDTH, WORLD_HEIGHT, rng);
+    }
+    preloader.recycle(std::move(terrain));
+    terrain = std::move(next.terrain);
+
+    // Place tanks
+    playerTank->setPosition(next.playerPosition);
+    playerTank->setAngle(45.f);
+    cpuTank->setPosition(next.cpuPosition);
+    cpuTank->setAngle(135.f);
+
+    // Reset projectile state
+    shell = sf::Vector2f(-100.f, -100.f); // Off-screen
+    shellVelocity = sf::Vector2f(0.f, 0.f);
+    shooting = false;
+
+    // Drop any search still running for the previous round
+    cpuAI.cancel();
+    cpuAI.invalidateAll();
+    cpuDecisionPending = false;
+
+    // Randomized first turn comes with the prepared round
+    playerTurn = next.playerFirst;
+    turnTimer = TURN_TIME;
+    camera.snapTo((playerTurn ? playerTank : cpuTank)->getPosition());
+
+    // Reset power settings
+    power = 0.0f;
+    powerDirection = 1.0f;
+    lastPlayerPower = 0.0f;
+
+    // Reset latency, shown with the debug overlay
+    lastResetMicros = resetClock.getElapsedTime().asMicroseconds();
+    lastResetPreloaded = preloaded;
+}
+
+void GameSession::adjustPlayerAngle(float delta) {
+    if (!canPlayerAct()) return;
+    playerTank->adjustAngle(delta);
+}
+
+void GameSession::updatePowerMeter(bool spacePressed) {
+    if (!canPlayerAct()) return;
+
+    // Reset power only when space is first pressed
+    if (spacePressed && !wasSpacePressed) {
+        power = 0.0f;
+        powerDirection = 1.0f;
+    }
+
+    // Update power while space is held
+    if (spacePressed) {
+        power += POWER_SPEED * powerDirection;
+
+        // Reverse direction at limits
+        if (power >= 100.0f) {
+            power = 100.0f;
+            powerDirection = -1.0f;
+        } else if (power <= 0.0f) {
+            power = 0.0f;
+            powerDirection = 1.0f;
+        }
+    }
+
+    wasSpacePressed = spacePressed;
+}
+
+void GameSession::releaseShot() {
+    if (!canPlayerAct()) return;
+    lastPlayerPower = power;  // Store the power used
+    shoot(*playerTank);
+    wasSpacePressed = false;
+}
+
+GameSession::Event GameSession::update(sf::Time deltaTime) {
+    updateCamera(deltaTime);
+
+    Event event = Event::None;
+    if (shooting) {
+        ShotRules::Result result = ShotRules::step(shell, shellVelocity, deltaTime.asSeconds(),
+                                                   terrain->getHeights(), shotTarget);
+        event = resolveShot(result);
+        if (event == Event::RoundOver) return event;
+    }
+
+    if (playerTurn) {
+        turnTimer--;
+        if (turnTimer <= 0) {
+            switchTurn();
+        }
+    }
+    else {
+        handleCPUTurn();
+    }
+    return event;
+}
+
+GameSession::Event GameSession::resolveShot(ShotRules::Result result) {
+    if (result == ShotRules::Result::HitTerrain) {
+        if (!playerTurn) {
+            // Record CPU shot data
+            sf::Vector2f playerPos = playerTank->getPosition();
+            float distance = std::sqrt(
+                std::pow(shell.x - playerPos.x, 2) +
+                std::pow(shell.y - playerPos.y, 2)
+            );
+
+            ShotData shot;
+            shot.angle = cpuTank->getAngle();
+            shot.power = power;
+            shot.impactPoint = shell;
+            shot.wasClose = distance < 50.f;
+
+            previousShots.push(shot);
+        }
+
+        recordShot(shell, false);
+        Terrain::ColumnRange changed = terrain->deform(shell, ShotRules::CRATER_RADIUS);
+        cpuAI.invalidateColumns(changed.first, changed.last);
+        shooting = false;
+        switchTurn();
+        return Event::Crater;
+    }
+
+    if (result == ShotRules::Result::HitTarget) {
+        recordShot(shell, true);
+        shooting = false;
+        return Event::RoundOver;
+    }
+
+    if (result == ShotRules::Result::OffWorld) {
+        recordShot(shell, false);
+        shooting = false;
+        switchTurn();
+    }
+    return Event::None;
+}
+
+void GameSession::shoot(const Tank& tank) {
+    shell = tank.getPosition();
+    shellVelocity = ShotRules::launchVelocity(tank.getAngle(), power);
+    shooting = true;
+
+    // Remember the situation before the impact deforms the terrain
+    shotOrigin = tank.getPosition();
+    shotTarget = (playerTurn ? cpuTank : playerTank)->getPosition();
+    shotAngle = tank.getAngle();
+    shotPower = power;
+    shotRidge = ShotLog::profileSignature(terrain->getHeights(), shotOrigin, shotTarget);
+}
+
+void GameSession::recordShot(sf::Vector2f impact, bool hit) {
+    try {
+        shotLog.append(shotOrigin, shotTarget, shotRidge, shotAngle, shotPower, impact, hit);
+    } catch (const std::exception& e) {
+        // A full disk should not end the game; stop logging instead
+        std::cerr << "Shot log disabled: " << e.what() << std::endl;
+        shotLog.close();
+    }
+}
+
+void GameSession::handleCPUTurn() {
+    if (turnTimer == TURN_TIME) {
+        startCPUSearch();
+    }
+
+    // Fire after the reaction delay, as soon as the search has published its answer
+    CpuAI::Decision decision;
+    if (cpuDecisionPending && turnTimer <= TURN_TIME - 10 && cpuAI.poll(decision)) {
+        cpuDecisionPending = false;
+
+        // Add small random variations to prevent getting stuck
+        float targetAngle = decision.angle + generateRandomFloat(-2.0f, 2.0f);
+        float targetPower = decision.power + generateRandomFloat(-3.0f, 3.0f);
+
+        cpuTank->setAngle(targetAngle);
+        power = targetPower;
+        shoot(*cpuTank);
+    }
+
+    turnTimer--;
+    if (turnTimer <= 0) {
+        switchTurn();
+    }
+}
+
+void GameSession::startCPUSearch() {
+    float targetAngle, targetPower;
+    sf::Vector2f playerPos = playerTank->getPosition();
+    sf::Vector2f cpuPos = cpuTank->getPosition();
+
+    // Calculate distance and height difference
+    float distanceX = playerPos.x - cpuPos.x;
+    float distanceY = playerPos.y - cpuPos.y;
+    float directDistance = std::sqrt(distanceX * distanceX + distanceY * distanceY);
+
+    // Initial shot or reset strategy
+    if (previousShots.empty()) {
+        // Randomly choose between direct or high arc for initial shot
+        bool useHighArc = (generateRandomInt(0, 1) == 1);
+
+        if (useHighArc) {
+            targetAngle = generateRandomFloat(140.0f, 180.0f);  // High arc
+            targetPower = directDistance / 5.0f;  // More power for high arc
+        } else {
+            targetAngle = generateRandomFloat(0.0f, 140.0f);  // Direct shot
+            targetPower = directDistance / 8.0f;  // Less power for direct shot
+        }
+    } else {
+        const auto& lastShot = previousShots.back();
+
+        if (lastShot.impactPoint.x < playerPos.x) {
+            // Hit terrain or fell short - try higher arc
+            if (lastShot.angle < 145.0f) {
+                // Current angle too low, switch to high arc strategy
+                targetAngle = generateRandomFloat(150.0f, 165.0f);
+                targetPower = lastShot.power + 15.0f;
+            } else {
+                // Already using high arc, increase both
+                targetAngle = lastShot.angle + 5.0f;
+                targetPower = lastShot.power + 10.0f;
+            }
+        } else {
+            // Overshot the target
+            if (lastShot.impactPoint.y < playerPos.y) {
+                // Too high, reduce angle but maintain arc strategy
+                targetAngle = lastShot.angle - 5.0f;
+                targetPower = lastShot.power - 5.0f;
+            } else {
+                // Too far but good height, reduce power
+                targetAngle = lastShot.angle;
+                targetPower = lastShot.power - 10.0f;
+            }
+        }
+
+        // Occasionally try completely different approach if missing repeatedly
+        if (previousShots.full()) {
+            bool allShortShots = true;
+            for (const auto& shot : previousShots) {
+                if (shot.impactPoint.x >= playerPos.x) {
+                    allShortShots = false;
+                    break;
+                }
+            }
+
+            if (allShortShots) {
+                // Switch to high arc strategy
+                targetAngle = generateRandomFloat(150.0f, 165.0f);
+                targetPower = directDistance / 5.0f;
+            }
+        }
+    }
+
+    // Refine the guess on the worker thread within the time budget. A near-hit from a
+    // similar situation in any earlier round goes along as the prior.
+    CpuAI::Request request;
+    request.shooter = cpuPos;
+    request.target = playerPos;
+    request.seedAngle = targetAngle;
+    request.seedPower = targetPower;
+    float ridge = ShotLog::profileSignature(terrain->getHeights(), cpuPos, playerPos);
+    request.hasPrior = shotLog.findNearest(cpuPos, playerPos, ridge, request.priorAngle, request.priorPower);
+    request.gravity = ShotRules::GRAVITY;
+    request.powerMultiplier = ShotRules::POWER_MULTIPLIER;
+    request.budget = CPU_THINK_BUDGET;
+    request.seed = rng();
+
+    cpuAI.start(request, terrain->getHeights());
+    cpuDecisionPending = true;
+}
+
+void GameSession::updateCamera(sf::Time deltaTime) {
+    // Follow the shell in flight, otherwise the tank whose turn it is
+    if (shooting) {
+        camera.follow(shell, deltaTime);
+    } else {
+        camera.follow((playerTurn ? playerTank : cpuTank)->getPosition(), deltaTime);
+    }
+}
+
+void GameSession::switchTurn() {
+    if (cpuDecisionPending) {
+        cpuAI.cancel();
+        cpuDecisionPending = false;
+    }
+    playerTurn = !playerTurn;
+    turnTimer = TURN_TIME;
+    power = 0.0f;
+    powerDirection = 1.0f;
+}
+
+Camera& GameSession::getCamera() {
+    return camera;
+}
+
+const Terrain& GameSession::getTerrain() const {
+    return *terrain;
+}
+
+const Tank& GameSession::getPlayerTank() const {
+    return *playerTank;
+}
+
+const Tank& GameSession::getCpuTank() const {
+    return *cpuTank;
+}
+
+bool GameSession::isShooting() const {
+    return shooting;
+}
+
+sf::Vector2f GameSession::getShellPosition() const {
+    return shell;
+}
+
+bool GameSession::isPlayerTurn() const {
+    return playerTurn;
+}
+
+bool GameSession::canPlayerAct() const {
+    return playerTurn && !shooting;
+}
+
+int GameSession::getTurnTimer() const {
+    return turnTimer;
+}
+
+float GameSession::getPower() const {
+    return power;
+}
+
+float GameSession::getLastPlayerPower() const {
+    return lastPlayerPower;
+}
+
+std::size_t GameSession::getShotLogSize() const {
+    return shotLog.size();
+}
+
+sf::Int64 GameSession::getLastResetMicros() const {
+    return lastResetMicros;
+}
+
+bool GameSession::wasLastResetPreloaded() const {
+    return lastResetPreloaded;
+}
+
+bool GameSession::copyHeatmap(std::vector<float>& out, std::uint64_t& version) const {
+    return cpuAI.copyHeatmap(out, version);
+}
+
+float GameSession::generateRandomFloat(float min, float max) {
+    std::uniform_real_distribution<float> dist(min, max);
+    return dist(rng);
+}
+
+int GameSession::generateRandomInt(int min, int max) {
+    std::uniform_int_distribution<int> dist(min, max);
+    return dist(rng);
+}
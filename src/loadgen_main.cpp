@@ -0,0 +1,108 @@
+#include "../include/local_socket.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct ClientResult {
+        std::vector<float> latencies;  // Request round trips in microseconds
+        std::size_t rejected = 0;
+    };
+
+    void runClient(const std::string& socketPath, std::size_t firstMatch, std::size_t matchCount,
+                   unsigned seed, const std::atomic<bool>& running, ClientResult& result) {
+        try {
+            LocalSocket socket = LocalSocket::connectTo(socketPath);
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<std::size_t> matchDist(firstMatch, firstMatch + matchCount - 1);
+            std::uniform_real_distribution<float> angleDist(0.0f, 180.0f);
+            std::uniform_real_distribution<float> powerDist(20.0f, 100.0f);
+
+            while (running.load()) {
+                std::string command = "FIRE " + std::to_string(matchDist(rng)) + " " +
+                                      std::to_string(angleDist(rng)) + " " +
+                                      std::to_string(powerDist(rng));
+                auto start = std::chrono::steady_clock::now();
+                std::string response = socket.request(command);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+
+                result.latencies.push_back(std::chrono::duration<float, std::micro>(elapsed).count());
+                if (response != "OK") result.rejected++;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Client error: " << e.what() << std::endl;
+        }
+    }
+}
+
+// Usage: ArtilleryLoadGen [socket-path] [matches] [seconds] [clients]
+// Creates matches on a running ArtilleryServer, then has each client fire random
+// shots at random matches as fast as the server answers, and reports request
+// round-trip percentiles alongside the server's own STATS line.
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : "/tmp/artillery.sock";
+    std::size_t matchCount = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 1000;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 10;
+    unsigned clientCount = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4])) : 4;
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        LocalSocket control = LocalSocket::connectTo(socketPath);
+        std::string created = control.request("CREATE " + std::to_string(matchCount));
+        std::cout << "CREATE -> " << created << std::endl;
+
+        if (created.rfind("OK ", 0) != 0) {
+            std::cerr << "Error: server refused to create matches" << std::endl;
+            return 1;
+        }
+        std::size_t firstMatch = static_cast<std::size_t>(std::atoll(created.c_str() + 3));
+
+        std::atomic<bool> running(true);
+        std::vector<ClientResult> results(clientCount);
+        std::vector<std::jthread> clients;
+
+        for (unsigned c = 0; c < clientCount; ++c) {
+            clients.emplace_back([&, c] {
+                runClient(socketPath, firstMatch, matchCount, c + 1, running, results[c]);
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        running.store(false);
+        clients.clear();
+
+        std::vector<float> all;
+        std::size_t totalRejected = 0;
+        for (unsigned c = 0; c < clientCount; ++c) {
+            all.insert(all.end(), results[c].latencies.begin(), results[c].latencies.end());
+            totalRejected += results[c].rejected;
+        }
+        std::sort(all.begin(), all.end());
+
+        auto percentile = [&all](float fraction) {
+            if (all.empty()) return 0.0f;
+            return all[std::min(all.size() - 1, static_cast<std::size_t>(fraction * all.size()))];
+        };
+
+        std::cout << "requests=" << all.size()
+                  << " per_second=" << (seconds > 0 ? all.size() / seconds : all.size())
+                  << " rejected=" << totalRejected
+                  << " rtt_p50_us=" << percentile(0.50f)
+                  << " rtt_p99_us=" << percentile(0.99f)
+                  << " rtt_max_us=" << (all.empty() ? 0.0f : all.back()) << std::endl;
+        std::cout << "STATS -> " << control.request("STATS") << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "../include/local_socket.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Callers ignore SIGPIPE where the flag is unavailable
+#endif
+
+namespace {
+    sockaddr_un makeAddress(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + path);
+        }
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+    std::runtime_error socketError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+}
+
+LocalSocket::LocalSocket()
+    : fd(-1) {
+}
+
+LocalSocket::LocalSocket(int fd)
+    : fd(fd) {
+}
+
+LocalSocket::~LocalSocket() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept
+    : fd(other.fd)
+    , pending(std::move(other.pending)) {
+    other.fd = -1;
+}
+
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = other.fd;
+        pending = std::move(other.pending);
+        other.fd = -1;
+    }
+    return *this;
+}
+
+LocalSocket LocalSocket::listenAt(const std::string& path) {
+    LocalSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.isValid()) throw socketError("Failed to create socket");
+
+    // A stale socket file from a previous run would make bind fail
+    ::unlink(path.c_str());
+    sockaddr_un address = makeAddress(path);
+    if (::bind(socket.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        throw socketError("Failed to bind " + path);
+    }
+    if (::listen(socket.fd, SOMAXCONN) < 0) {
+        throw socketError("Failed to listen on " + path);
+    }
+    socket.setNonBlocking();
+    return socket;
+}
+
+LocalSocket LocalSocket::connectTo(const std::string& path) {
+    LocalSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.isValid()) throw socketError("Failed to create socket");
+
+    sockaddr_un address = makeAddress(path);
+    if (::connect(socket.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        throw socketError("Failed to connect to " + path);
+    }
+    return socket;
+}
+
+LocalSocket LocalSocket::accept() {
+    int client = ::accept(fd, nullptr, nullptr);
+    if (client < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return LocalSocket();
+        throw socketError("Failed to accept client");
+    }
+    LocalSocket socket(client);
+    socket.setNonBlocking();
+    return socket;
+}
+
+bool LocalSocket::receive(std::string& buffer) {
+    char chunk[4096];
+    while (true) {
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+            buffer.append(chunk, static_cast<std::size_t>(received));
+            continue;
+        }
+        if (received == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+bool LocalSocket::takeLine(std::string& buffer, std::string& line) {
+    std::size_t newline = buffer.find('\n');
+    if (newline == std::string::npos) return false;
+
+    line.assign(buffer, 0, newline);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    buffer.erase(0, newline + 1);
+    return true;
+}
+
+bool LocalSocket::flush(std::string& buffer) {
+    std::size_t sent = 0;
+    while (sent < buffer.size()) {
+        ssize_t written = ::send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            throw socketError("Failed to send");
+        }
+        sent += static_cast<std::size_t>(written);
+    }
+    buffer.erase(0, sent);
+    return buffer.empty();
+}
+
+void LocalSocket::sendAll(const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw socketError("Failed to send");
+        }
+        sent += static_cast<std::size_t>(written);
+    }
+}
+
+std::string LocalSocket::request(const std::string& line) {
+    sendAll(line + "\n");
+
+    std::string response;
+    char chunk[4096];
+    while (!takeLine(pending, response)) {
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received == 0) throw std::runtime_error("Server closed the connection");
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            throw socketError("Failed to receive");
+        }
+        pending.append(chunk, static_cast<std::size_t>(received));
+    }
+    return response;
+}
+
+void LocalSocket::setNonBlocking() {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+int LocalSocket::getDescriptor() const {
+    return fd;
+}
+
+bool LocalSocket::isValid() const {
+    return fd >= 0;
+}
@@ -0,0 +1,97 @@
+#include "../include/match.h"
+
+Match::Match(std::uint32_t seed)
+    : terrain(ShotRules::WORLD_WIDTH, ShotRules::WORLD_HEIGHT, Terrain::MeshMode::None)
+    , shotAngle(0.0f)
+    , shotPower(0.0f)
+    , shooting(false)
+    , side(0)
+    , turnTimer(ShotRules::TURN_TIME)
+    , rounds(0)
+    , wins{0, 0}
+    , rng(seed) {
+
+    startRound();
+}
+
+void Match::startRound() {
+    terrain.generate(static_cast<std::uint32_t>(rng()));
+
+    ShotRules::Placement placement = ShotRules::placeTanks(terrain, ShotRules::WORLD_WIDTH, rng);
+    tanks[0] = placement.left;
+    tanks[1] = placement.right;
+
+    shooting = false;
+    side = placement.leftFirst ? 0 : 1;
+    turnTimer = ShotRules::TURN_TIME;
+    history.clear();
+}
+
+bool Match::fire(float angle, float power) {
+    if (shooting) return false;
+
+    projectile = tanks[side];
+    projectileVelocity = ShotRules::launchVelocity(angle, power);
+    shotAngle = angle;
+    shotPower = power;
+    shooting = true;
+    return true;
+}
+
+void Match::step(float deltaSeconds) {
+    if (shooting) {
+        switch (ShotRules::step(projectile, projectileVelocity, deltaSeconds,
+                                terrain.getHeights(), tanks[1 - side])) {
+            case ShotRules::Result::HitTerrain:
+                terrain.deform(projectile, ShotRules::CRATER_RADIUS);
+                endShot();
+                return;
+            case ShotRules::Result::HitTarget:
+                wins[side]++;
+                rounds++;
+                startRound();
+                return;
+            case ShotRules::Result::OffWorld:
+                endShot();
+                return;
+            case ShotRules::Result::Flying:
+                break;
+        }
+    }
+
+    turnTimer--;
+    if (turnTimer <= 0) {
+        switchTurn();
+    }
+}
+
+void Match::endShot() {
+    history.push(ShotRecord{side, shotAngle, shotPower, projectile});
+    shooting = false;
+    switchTurn();
+}
+
+void Match::switchTurn() {
+    side = 1 - side;
+    turnTimer = ShotRules::TURN_TIME;
+}
+
+Match::Status Match::getStatus() const {
+    Status status;
+    status.side = side;
+    status.turnTimer = turnTimer;
+    status.shooting = shooting;
+    status.rounds = rounds;
+    status.wins[0] = wins[0];
+    status.wins[1] = wins[1];
+    return status;
+}
+
+const RingBuffer<Match::ShotRecord, Match::SHOT_HISTORY_SIZE>& Match::getHistory() const {
+    return history;
+}
+
+std::size_t Match::getMemoryFootprint() const {
+    // Terrain's footprint already includes its own object size
+    return sizeof(Match) - sizeof(Terrain) + terrain.getMemoryFootprint();
+}
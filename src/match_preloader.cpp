@@ -0,0 +1,78 @@
+#include "../include/match_preloader.h"
+#include "../include/shot_rules.h"
+
+MatchPreloader::MatchPreloader(int worldWidth, int worldHeight)
+    : worldWidth(worldWidth)
+    , worldHeight(worldHeight)
+    , readyHead(0)
+    , readyCount(0) {
+
+    spareTerrains.reserve(QUEUE_SIZE + 1);
+    worker = std::jthread([this](std::stop_token stopToken) { workerLoop(stopToken); });
+}
+
+MatchPreloader::~MatchPreloader() {
+    worker.request_stop();
+}
+
+bool MatchPreloader::take(PreparedMatch& match) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (readyCount == 0) return false;
+
+        match = std::move(ready[readyHead]);
+        readyHead = (readyHead + 1) % QUEUE_SIZE;
+        readyCount--;
+    }
+
+    // A slot opened up; start on the next round
+    wakeup.notify_one();
+    return true;
+}
+
+void MatchPreloader::recycle(std::unique_ptr<Terrain> terrain) {
+    if (!terrain) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (spareTerrains.size() < spareTerrains.capacity()) {
+        spareTerrains.push_back(std::move(terrain));
+    }
+}
+
+void MatchPreloader::prepare(PreparedMatch& match, int worldWidth, int worldHeight, std::mt19937& rng) {
+    if (!match.terrain) {
+        match.terrain = std::make_unique<Terrain>(worldWidth, worldHeight, Terrain::MeshMode::Adaptive);
+    }
+    match.terrain->generate(static_cast<std::uint32_t>(rng()));
+
+    ShotRules::Placement placement = ShotRules::placeTanks(*match.terrain, worldWidth, rng);
+    match.playerPosition = placement.left;
+    match.cpuPosition = placement.right;
+    match.playerFirst = placement.leftFirst;
+}
+
+void MatchPreloader::workerLoop(std::stop_token stopToken) {
+    std::random_device rd;
+    std::mt19937 rng(rd());
+
+    while (true) {
+        PreparedMatch match;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!wakeup.wait(lock, stopToken, [this] { return readyCount < QUEUE_SIZE; })) {
+                return;
+            }
+            if (!spareTerrains.empty()) {
+                match.terrain = std::move(spareTerrains.back());
+                spareTerrains.pop_back();
+            }
+        }
+
+        // The expensive part runs without the lock
+        prepare(match, worldWidth, worldHeight, rng);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[(readyHead + readyCount) % QUEUE_SIZE] = std::move(match);
+        readyCount++;
+    }
+}
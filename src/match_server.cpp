@@ -0,0 +1,265 @@
+#include "../include/match_server.h"
+#include "../include/local_socket.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <poll.h>
+
+MatchServer::MatchServer(unsigned threadCount)
+    : scheduler(threadCount)
+    , nextSeed(1)
+    , lastStepMicros(0.0f)
+    , lastTickMatches(0)
+    , ticks(0)
+    , overruns(0) {
+}
+
+void MatchServer::run(const std::string& socketPath, const std::atomic<bool>& stopRequested) {
+    // Bind before starting the client thread so a bad path fails loudly here
+    LocalSocket listener = LocalSocket::listenAt(socketPath);
+    std::jthread clients([this, &listener](std::stop_token stopToken) {
+        serveClients(listener, stopToken);
+    });
+
+    using Clock = std::chrono::steady_clock;
+    const auto tickInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(TICK_SECONDS));
+    auto nextTick = Clock::now();
+    auto nextReport = Clock::now() + std::chrono::seconds(REPORT_INTERVAL_SECONDS);
+
+    while (!stopRequested.load()) {
+        tick(nextTick);
+
+        // Fixed rate; when a tick overruns, start the next one immediately
+        nextTick += tickInterval;
+        auto now = Clock::now();
+        if (now > nextTick) {
+            nextTick = now;
+            std::lock_guard<std::mutex> lock(mutex);
+            overruns++;
+        } else {
+            std::this_thread::sleep_until(nextTick);
+        }
+
+        if (Clock::now() >= nextReport) {
+            nextReport += std::chrono::seconds(REPORT_INTERVAL_SECONDS);
+            Stats stats = getStats();
+            std::cout << "matches=" << stats.matches
+                      << " bytes_per_match=" << stats.bytesPerMatch
+                      << " tick_p50_us=" << stats.tickP50
+                      << " tick_p99_us=" << stats.tickP99
+                      << " tick_max_us=" << stats.tickMax
+                      << " overruns=" << stats.overruns << std::endl;
+        }
+    }
+}
+
+void MatchServer::tick(std::chrono::steady_clock::time_point scheduled) {
+    // Latency counts from the scheduled time, so waiting for the lock or a late
+    // wake-up shows up in the percentiles rather than only the stepping itself
+    std::lock_guard<std::mutex> lock(mutex);
+    auto start = std::chrono::steady_clock::now();
+
+    auto step = [this](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            matches[i]->step(TICK_SECONDS);
+        }
+    };
+    scheduler.parallelFor(matches.size(), TICK_GRAIN, step);
+
+    auto end = std::chrono::steady_clock::now();
+    lastStepMicros = std::chrono::duration<float, std::micro>(end - start).count();
+    lastTickMatches = matches.size();
+    tickLatencies.push(std::chrono::duration<float, std::micro>(end - scheduled).count());
+    ticks++;
+}
+
+std::size_t MatchServer::createMatches(std::size_t count) {
+    // Claim the seeds, then build the matches without holding up ticks
+    std::uint32_t firstSeed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        firstSeed = nextSeed;
+        nextSeed += static_cast<std::uint32_t>(count);
+    }
+
+    std::vector<std::unique_ptr<Match>> created;
+    created.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        created.push_back(std::make_unique<Match>(firstSeed + static_cast<std::uint32_t>(i)));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t first = matches.size();
+    matches.insert(matches.end(), std::make_move_iterator(created.begin()),
+                   std::make_move_iterator(created.end()));
+    return first;
+}
+
+MatchServer::Stats MatchServer::getStats() {
+    Stats stats{};
+    std::vector<float> latencies;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.matches = matches.size();
+        for (const auto& match : matches) {
+            stats.totalBytes += match->getMemoryFootprint();
+        }
+        stats.ticks = ticks;
+        stats.overruns = overruns;
+        if (lastTickMatches > 0) {
+            stats.stepNanosPerMatch = lastStepMicros * 1000.0f / lastTickMatches;
+        }
+        latencies.assign(tickLatencies.begin(), tickLatencies.end());
+    }
+
+    stats.bytesPerMatch = stats.matches > 0 ? stats.totalBytes / stats.matches : 0;
+    stats.steals = scheduler.getStealCount();
+
+    if (!latencies.empty()) {
+        auto percentile = [&latencies](float fraction) {
+            std::size_t index = std::min(latencies.size() - 1,
+                                         static_cast<std::size_t>(fraction * latencies.size()));
+            std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+            return latencies[index];
+        };
+        stats.tickP50 = percentile(0.50f);
+        stats.tickP90 = percentile(0.90f);
+        stats.tickP99 = percentile(0.99f);
+        stats.tickMax = *std::max_element(latencies.begin(), latencies.end());
+    }
+    return stats;
+}
+
+std::string MatchServer::handleCommand(const std::string& line) {
+    std::istringstream input(line);
+    std::string command;
+    input >> command;
+
+    if (command == "CREATE") {
+        std::size_t count = 1;
+        if (!(input >> count) || count == 0 || count > MAX_CREATE_COUNT) {
+            return "ERR usage: CREATE <count> with 1 <= count <= " + std::to_string(MAX_CREATE_COUNT);
+        }
+        std::size_t first = createMatches(count);
+        return "OK " + std::to_string(first) + " " + std::to_string(count);
+    }
+
+    if (command == "FIRE") {
+        std::size_t id;
+        float angle, power;
+        if (!(input >> id >> angle >> power)) return "ERR usage: FIRE <id> <angle> <power>";
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (id >= matches.size()) return "ERR no such match";
+        if (!matches[id]->fire(std::clamp(angle, 0.0f, 180.0f), std::clamp(power, 0.0f, 100.0f))) {
+            return "ERR shell in flight";
+        }
+        return "OK";
+    }
+
+    if (command == "STATE") {
+        std::size_t id;
+        if (!(input >> id)) return "ERR usage: STATE <id>";
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (id >= matches.size()) return "ERR no such match";
+        Match::Status status = matches[id]->getStatus();
+        std::ostringstream output;
+        output << "OK side=" << status.side
+               << " timer=" << status.turnTimer
+               << " shooting=" << (status.shooting ? 1 : 0)
+               << " rounds=" << status.rounds
+               << " wins=" << status.wins[0] << "," << status.wins[1];
+        return output.str();
+    }
+
+    if (command == "STATS") {
+        Stats stats = getStats();
+        std::ostringstream output;
+        output << "OK matches=" << stats.matches
+               << " bytes_per_match=" << stats.bytesPerMatch
+               << " total_bytes=" << stats.totalBytes
+               << " ticks=" << stats.ticks
+               << " tick_p50_us=" << stats.tickP50
+               << " tick_p90_us=" << stats.tickP90
+               << " tick_p99_us=" << stats.tickP99
+               << " tick_max_us=" << stats.tickMax
+               << " step_ns_per_match=" << stats.stepNanosPerMatch
+               << " steals=" << stats.steals
+               << " overruns=" << stats.overruns
+               << " threads=" << scheduler.getThreadCount();
+        return output.str();
+    }
+
+    return "ERR unknown command";
+}
+
+void MatchServer::serveClients(LocalSocket& listener, std::stop_token stopToken) {
+    // Responses wait in outgoing until the client reads them, so one slow
+    // reader never holds up the others
+    struct Client {
+        LocalSocket socket;
+        std::string buffer;
+        std::string outgoing;
+    };
+
+    std::vector<Client> clients;
+    std::vector<pollfd> descriptors;
+    std::string line;
+
+    while (!stopToken.stop_requested()) {
+        descriptors.clear();
+        descriptors.push_back(pollfd{listener.getDescriptor(), POLLIN, 0});
+        for (const auto& client : clients) {
+            short events = client.outgoing.empty() ? POLLIN : POLLIN | POLLOUT;
+            descriptors.push_back(pollfd{client.socket.getDescriptor(), events, 0});
+        }
+
+        if (::poll(descriptors.data(), descriptors.size(), POLL_TIMEOUT_MS) <= 0) continue;
+
+        // Read before accepting so descriptor indices still line up with clients
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            short revents = descriptors[i + 1].revents;
+            if (!(revents & (POLLIN | POLLOUT | POLLHUP | POLLERR))) continue;
+
+            Client& client = clients[i];
+            bool open = true;
+            try {
+                if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                    open = client.socket.receive(client.buffer);
+                    while (open && LocalSocket::takeLine(client.buffer, line)) {
+                        if (line == "QUIT") {
+                            open = false;
+                            break;
+                        }
+                        client.outgoing += handleCommand(line);
+                        client.outgoing += '\n';
+                    }
+                }
+                if (!client.socket.flush(client.outgoing) && client.outgoing.size() > MAX_CLIENT_OUTPUT) {
+                    std::cerr << "Client stopped reading; dropping it" << std::endl;
+                    open = false;
+                }
+            } catch (const std::exception& e) {
+                // A client that vanished mid-response only loses its own connection
+                std::cerr << "Client error: " << e.what() << std::endl;
+                open = false;
+            }
+            if (!open) {
+                client.socket = LocalSocket();
+            }
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const Client& client) { return !client.socket.isValid(); }),
+                      clients.end());
+
+        if (descriptors[0].revents & POLLIN) {
+            for (LocalSocket socket = listener.accept(); socket.isValid(); socket = listener.accept()) {
+                clients.push_back(Client{std::move(socket), std::string(), std::string()});
+            }
+        }
+    }
+}
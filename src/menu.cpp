@@ -82,6 +82,13 @@ void Menu::updateSelections(const sf::Vector2f& mousePos) {
     }
 }
 
+void Menu::reset() {
+    for(auto& item : items) {
+        item.selected = false;
+        item.clicked = false;
+    }
+}
+
 bool Menu::isItemSelected(int index) const {
     if(index >= 0 && index < items.size()) {
         return items[index].selected;
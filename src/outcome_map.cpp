@@ -0,0 +1,175 @@
+#include "../include/outcome_map.h"
+#include <algorithm>
+
+OutcomeMap::OutcomeMap(unsigned workerCount)
+    : params{}
+    , configured(false)
+    , cells(CELL_COUNT)
+    , refreshHeights(nullptr)
+    , refreshLimit(nullptr)
+    , nextDirty(0)
+    , refreshed(0)
+    , refreshRound(0)
+    , busyWorkers(0) {
+
+    dirtyCells.reserve(CELL_COUNT);
+    invalidateAll();
+
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back([this](std::stop_token stopToken) { workerLoop(stopToken); });
+    }
+}
+
+OutcomeMap::~OutcomeMap() {
+    for (auto& worker : workers) {
+        worker.request_stop();
+    }
+}
+
+void OutcomeMap::configure(const Ballistics::Params& newParams) {
+    bool changed = !configured ||
+                   newParams.shooter != params.shooter ||
+                   newParams.target != params.target ||
+                   newParams.gravity != params.gravity ||
+                   newParams.powerMultiplier != params.powerMultiplier ||
+                   newParams.worldHeight != params.worldHeight;
+
+    params = newParams;
+    configured = true;
+    if (changed) {
+        invalidateAll();
+    }
+}
+
+void OutcomeMap::invalidateColumns(int first, int last) {
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        Cell& cell = cells[i];
+        if (!cell.dirty && cell.outcome.maxColumn >= first && cell.outcome.minColumn <= last) {
+            cell.dirty = true;
+            dirtyCells.push_back(i);
+        }
+    }
+}
+
+void OutcomeMap::invalidateAll() {
+    dirtyCells.clear();
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        cells[i].dirty = true;
+        dirtyCells.push_back(i);
+    }
+}
+
+std::size_t OutcomeMap::refresh(const std::vector<float>& heights) {
+    RefreshLimit unlimited{std::chrono::steady_clock::time_point::max(), nullptr, 0};
+    return refresh(heights, unlimited);
+}
+
+std::size_t OutcomeMap::refresh(const std::vector<float>& heights, const RefreshLimit& limit) {
+    if (dirtyCells.empty()) return 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        refreshHeights = &heights;
+        refreshLimit = &limit;
+        nextDirty.store(0);
+        refreshed.store(0);
+        busyWorkers = static_cast<unsigned>(workers.size());
+        refreshRound++;
+    }
+    wakeup.notify_all();
+
+    // The calling thread takes chunks too, so a map without helpers still refreshes
+    processDirtyCells();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+    refreshHeights = nullptr;
+    refreshLimit = nullptr;
+
+    // Keep whatever an interrupted refresh did not reach for the next one
+    dirtyCells.erase(std::remove_if(dirtyCells.begin(), dirtyCells.end(),
+                                    [this](int index) { return !cells[index].dirty; }),
+                     dirtyCells.end());
+    return refreshed.load();
+}
+
+const OutcomeMap::Cell& OutcomeMap::at(int angleIndex, int powerIndex) const {
+    return cells[angleIndex * POWER_STEPS + powerIndex];
+}
+
+int OutcomeMap::bestCell() const {
+    int best = -1;
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        if (cells[i].dirty) continue;
+        if (best < 0 || cells[i].outcome.missDistance < cells[best].outcome.missDistance) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int OutcomeMap::closestCell(float angle, float power, float maxMiss) const {
+    int best = -1;
+    float bestDistance = 0.0f;
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        if (cells[i].dirty || cells[i].outcome.missDistance > maxMiss) continue;
+        float da = angleAt(i) - angle;
+        float dp = powerAt(i) - power;
+        float distance = da * da + dp * dp;
+        if (best < 0 || distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+std::size_t OutcomeMap::getDirtyCount() const {
+    return dirtyCells.size();
+}
+
+void OutcomeMap::workerLoop(std::stop_token stopToken) {
+    std::uint64_t seenRound = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!wakeup.wait(lock, stopToken, [&] { return refreshRound != seenRound; })) {
+                return;
+            }
+            seenRound = refreshRound;
+        }
+
+        processDirtyCells();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void OutcomeMap::processDirtyCells() {
+    const std::size_t total = dirtyCells.size();
+    while (!isInterrupted()) {
+        std::size_t begin = nextDirty.fetch_add(REFRESH_CHUNK);
+        if (begin >= total) return;
+
+        // Each cell belongs to exactly one chunk, so marking it clean here is race-free
+        std::size_t end = std::min(total, begin + REFRESH_CHUNK);
+        for (std::size_t i = begin; i < end; ++i) {
+            int index = dirtyCells[i];
+            cells[index].outcome = Ballistics::simulate(params, *refreshHeights, angleAt(index), powerAt(index));
+            cells[index].dirty = false;
+        }
+        refreshed.fetch_add(end - begin);
+    }
+}
+
+bool OutcomeMap::isInterrupted() const {
+    if (refreshLimit->generation &&
+        refreshLimit->generation->load(std::memory_order_relaxed) != refreshLimit->expectedGeneration) {
+        return true;
+    }
+    return std::chrono::steady_clock::now() >= refreshLimit->deadline;
+}
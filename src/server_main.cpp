@@ -0,0 +1,41 @@
+#include "../include/match_server.h"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace {
+    std::atomic<bool> stopRequested(false);
+
+    void requestStop(int) {
+        stopRequested.store(true);
+    }
+}
+
+// Usage: ArtilleryServer [socket-path] [threads] [initial-matches]
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : "/tmp/artillery.sock";
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                : std::thread::hardware_concurrency();
+    std::size_t initialMatches = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 0;
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        MatchServer server(threads);
+        if (initialMatches > 0) {
+            server.createMatches(initialMatches);
+        }
+
+        std::cout << "Serving on " << socketPath << " with " << threads << " threads" << std::endl;
+        server.run(socketPath, stopRequested);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,404 @@
+#include "../include/shot_log.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable_v<ShotLog::Record>, "Records are written straight into the mapping");
+static_assert(sizeof(ShotLog::Record) == 32, "Changing the record layout needs a VERSION bump");
+
+ShotLog::ShotLog(float maxDx, float maxDy)
+#ifdef _WIN32
+    : file(nullptr)
+    , fileMapping(nullptr)
+#else
+    : fd(-1)
+#endif
+    , mapping(nullptr)
+    , mappedBytes(0)
+    , capacity(0)
+    , gridWidth(static_cast<int>(std::ceil(maxDx / CELL_SIZE)) + 1)
+    , gridHeight(static_cast<int>(std::ceil(2.0f * maxDy / CELL_SIZE)) + 1)
+    , gridDepth(static_cast<int>(std::ceil(maxDy / CELL_SIZE)) + 1)
+    , maxDy(maxDy)
+    , grid(static_cast<std::size_t>(gridWidth) * gridHeight * gridDepth, Cell{{}, {}, 0}) {
+}
+
+ShotLog::~ShotLog() {
+    close();
+}
+
+#ifdef _WIN32
+
+namespace {
+    std::runtime_error logError(const std::string& what) {
+        return std::runtime_error(what + ": error " + std::to_string(::GetLastError()));
+    }
+}
+
+void ShotLog::open(const std::string& path) {
+    close();
+
+    HANDLE handle = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                  nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) throw logError("Cannot open shot log " + path);
+    file = handle;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(handle, &size)) {
+        close();
+        throw logError("Cannot stat shot log " + path);
+    }
+
+    load(static_cast<std::size_t>(size.QuadPart), path);
+}
+
+void ShotLog::remap(std::size_t newCapacity) {
+    std::size_t bytes = sizeof(Header) + newCapacity * sizeof(Record);
+
+    if (mapping) {
+        ::UnmapViewOfFile(mapping);
+        mapping = nullptr;
+    }
+    if (fileMapping) {
+        ::CloseHandle(fileMapping);
+        fileMapping = nullptr;
+    }
+
+    // A mapping larger than the file grows the file to match
+    std::uint64_t size = bytes;
+    HANDLE section = ::CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size >> 32),
+                                          static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    if (!section) {
+        throw logError("Cannot grow shot log");
+    }
+    fileMapping = section;
+
+    void* address = ::MapViewOfFile(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+    if (!address) {
+        throw logError("Cannot map shot log");
+    }
+
+    mapping = address;
+    mappedBytes = bytes;
+    capacity = newCapacity;
+}
+
+void ShotLog::close() {
+    if (mapping) {
+        // Trim the unused tail so the file only holds real records. Windows refuses to
+        // truncate a mapped file, so the view and the section go first.
+        std::size_t used = sizeof(Header) + header()->count * sizeof(Record);
+        ::UnmapViewOfFile(mapping);
+        mapping = nullptr;
+        if (fileMapping) {
+            ::CloseHandle(fileMapping);
+            fileMapping = nullptr;
+        }
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(used);
+        if (!::SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !::SetEndOfFile(file)) {
+            // Harmless: the header count still marks where the records end
+        }
+    }
+    if (fileMapping) {
+        ::CloseHandle(fileMapping);
+        fileMapping = nullptr;
+    }
+    if (file) {
+        ::CloseHandle(file);
+        file = nullptr;
+    }
+    mappedBytes = 0;
+    capacity = 0;
+}
+
+#else
+
+namespace {
+    std::runtime_error logError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+}
+
+void ShotLog::open(const std::string& path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) throw logError("Cannot open shot log " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        close();
+        throw logError("Cannot stat shot log " + path);
+    }
+
+    load(static_cast<std::size_t>(info.st_size), path);
+}
+
+void ShotLog::remap(std::size_t newCapacity) {
+    std::size_t bytes = sizeof(Header) + newCapacity * sizeof(Record);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        throw logError("Cannot grow shot log");
+    }
+
+    if (mapping) {
+        ::munmap(mapping, mappedBytes);
+        mapping = nullptr;
+    }
+    void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        throw logError("Cannot map shot log");
+    }
+
+    mapping = address;
+    mappedBytes = bytes;
+    capacity = newCapacity;
+}
+
+void ShotLog::close() {
+    if (mapping) {
+        // Trim the unused tail so the file only holds real records
+        std::size_t used = sizeof(Header) + header()->count * sizeof(Record);
+        ::munmap(mapping, mappedBytes);
+        if (::ftruncate(fd, static_cast<off_t>(used)) != 0) {
+            // Harmless: the header count still marks where the records end
+        }
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mappedBytes = 0;
+    capacity = 0;
+}
+
+#endif
+
+// Maps an opened file of fileBytes bytes and indexes the shots already in it
+void ShotLog::load(std::size_t fileBytes, const std::string& path) {
+    bool fresh = fileBytes == 0;
+    std::size_t existing = 0;
+    if (!fresh) {
+        if (fileBytes < sizeof(Header)) {
+            close();
+            throw std::runtime_error("Shot log is truncated: " + path);
+        }
+        existing = (fileBytes - sizeof(Header)) / sizeof(Record);
+    }
+
+    try {
+        remap(std::max(existing, INITIAL_CAPACITY));
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    Header* head = header();
+    if (fresh) {
+        *head = Header{MAGIC, VERSION, static_cast<std::uint32_t>(sizeof(Record)), 0, 0, 0};
+    } else if (head->magic != MAGIC || head->version != VERSION ||
+               head->recordSize != sizeof(Record) || head->count > capacity) {
+        close();
+        throw std::runtime_error("Unrecognised shot log format: " + path);
+    }
+
+    // One linear pass at startup; afterwards the index is kept up to date by append
+    for (Cell& cell : grid) {
+        cell.count = 0;
+    }
+    for (std::uint64_t i = 0; i < head->count; ++i) {
+        index(static_cast<std::uint32_t>(i));
+    }
+}
+
+bool ShotLog::isOpen() const {
+    return mapping != nullptr;
+}
+
+std::size_t ShotLog::size() const {
+    return mapping ? static_cast<std::size_t>(header()->count) : 0;
+}
+
+ShotLog::Header* ShotLog::header() const {
+    return static_cast<Header*>(mapping);
+}
+
+ShotLog::Record* ShotLog::records() const {
+    return reinterpret_cast<Record*>(static_cast<char*>(mapping) + sizeof(Header));
+}
+
+ShotLog::Situation ShotLog::normalize(sf::Vector2f shooter, sf::Vector2f target, float ridge) {
+    // Mirror so the target is always to the right of the shooter
+    return Situation{std::abs(target.x - shooter.x), target.y - shooter.y, ridge};
+}
+
+void ShotLog::append(sf::Vector2f shooter, sf::Vector2f target, float ridge,
+                     float angle, float power, sf::Vector2f impact, bool hit) {
+    if (!mapping) return;
+
+    if (header()->count == capacity) {
+        remap(capacity * 2);
+    }
+
+    bool mirrored = target.x < shooter.x;
+    Situation situation = normalize(shooter, target, ridge);
+
+    Record record;
+    record.dx = situation.dx;
+    record.dy = situation.dy;
+    record.ridge = situation.ridge;
+    record.angle = mirrored ? 180.0f - angle : angle;
+    record.power = power;
+    record.missX = mirrored ? target.x - impact.x : impact.x - target.x;
+    record.missY = impact.y - target.y;
+    record.flags = hit ? FLAG_HIT : 0;
+
+    // Publish the record before the count so a crash never exposes a partial one
+    std::uint32_t recordIndex = static_cast<std::uint32_t>(header()->count);
+    records()[recordIndex] = record;
+    header()->count++;
+
+    index(recordIndex);
+}
+
+int ShotLog::cellIndex(int cellX, int cellY, int cellZ) const {
+    return (cellZ * gridHeight + cellY) * gridWidth + cellX;
+}
+
+// Ridge is measured in the same units as dx and dy, so cells stay cubes and the
+// ring search bound holds on all three axes. Ground below the shooter counts as flat.
+void ShotLog::cellOf(const Situation& situation, int& cellX, int& cellY, int& cellZ) const {
+    cellX = std::clamp(static_cast<int>(situation.dx / CELL_SIZE), 0, gridWidth - 1);
+    cellY = std::clamp(static_cast<int>((situation.dy + maxDy) / CELL_SIZE), 0, gridHeight - 1);
+    cellZ = std::clamp(static_cast<int>(situation.ridge / CELL_SIZE), 0, gridDepth - 1);
+}
+
+void ShotLog::index(std::uint32_t recordIndex) {
+    const Record& record = records()[recordIndex];
+    float miss = (record.flags & FLAG_HIT) ? 0.0f : std::hypot(record.missX, record.missY);
+    if (miss > SUCCESS_DISTANCE) return;
+
+    int cellX, cellY, cellZ;
+    cellOf(Situation{record.dx, record.dy, record.ridge}, cellX, cellY, cellZ);
+    Cell& cell = grid[cellIndex(cellX, cellY, cellZ)];
+
+    // Keep the cell sorted by miss distance; a full cell drops its worst entry.
+    // Equal misses favour the newer shot, which saw the more recent terrain.
+    std::size_t slot = 0;
+    while (slot < cell.count && cell.misses[slot] < miss) {
+        ++slot;
+    }
+    if (slot == CELL_CAPACITY) return;
+
+    std::size_t last = std::min(cell.count, CELL_CAPACITY - 1);
+    for (std::size_t i = last; i > slot; --i) {
+        cell.records[i] = cell.records[i - 1];
+        cell.misses[i] = cell.misses[i - 1];
+    }
+    cell.records[slot] = recordIndex;
+    cell.misses[slot] = miss;
+    cell.count = std::min(cell.count + 1, CELL_CAPACITY);
+}
+
+bool ShotLog::findNearest(sf::Vector2f shooter, sf::Vector2f target, float ridge,
+                          float& angle, float& power) const {
+    if (!mapping) return false;
+
+    Situation situation = normalize(shooter, target, ridge);
+    int centerX, centerY, centerZ;
+    cellOf(situation, centerX, centerY, centerZ);
+
+    const Record* all = records();
+    const Record* best = nullptr;
+    float bestScore = std::numeric_limits<float>::max();
+
+    // Walk rings of cells outwards; stop once a ring cannot beat the best match
+    // Distance from the query to a cell along one axis; edge cells also hold
+    // everything clamped into them, so they are unbounded outwards
+    auto axisGap = [](int cell, int cells, float position) {
+        float lower = cell * CELL_SIZE;
+        if (cell > 0 && position < lower) return lower - position;
+        if (cell < cells - 1 && position > lower + CELL_SIZE) return position - lower - CELL_SIZE;
+        return 0.0f;
+    };
+
+    for (int ring = 0; ring <= MAX_SEARCH_RING; ++ring) {
+        float ringDistance = (ring - 1) * CELL_SIZE;
+        if (best && ring > 0 && ringDistance * ringDistance > bestScore) break;
+
+        for (int cellZ = centerZ - ring; cellZ <= centerZ + ring; ++cellZ) {
+            if (cellZ < 0 || cellZ >= gridDepth) continue;
+            bool zBorder = std::abs(cellZ - centerZ) == ring;
+            float gapZ = axisGap(cellZ, gridDepth, situation.ridge);
+            for (int cellY = centerY - ring; cellY <= centerY + ring; ++cellY) {
+                if (cellY < 0 || cellY >= gridHeight) continue;
+                bool yBorder = zBorder || std::abs(cellY - centerY) == ring;
+                float gapY = axisGap(cellY, gridHeight, situation.dy + maxDy);
+                for (int cellX = centerX - ring; cellX <= centerX + ring; ++cellX) {
+                    if (cellX < 0 || cellX >= gridWidth) continue;
+                    // Only the ring's surface; the inside was visited already
+                    if (!yBorder && std::abs(cellX - centerX) != ring) continue;
+
+                    const Cell& cell = grid[cellIndex(cellX, cellY, cellZ)];
+                    if (cell.count == 0) continue;
+                    float gapX = axisGap(cellX, gridWidth, situation.dx);
+                    float cellDistance = gapX * gapX + gapY * gapY + gapZ * gapZ;
+
+                    // Entries are sorted by miss, so stop once even the distance to the cell loses
+                    for (std::size_t i = 0; i < cell.count; ++i) {
+                        if (cellDistance + cell.misses[i] * cell.misses[i] >= bestScore) break;
+                        const Record& record = all[cell.records[i]];
+                        float ddx = record.dx - situation.dx;
+                        float ddy = record.dy - situation.dy;
+                        float dridge = record.ridge - situation.ridge;
+                        float score = ddx * ddx + ddy * ddy + dridge * dridge + cell.misses[i] * cell.misses[i];
+                        if (score < bestScore) {
+                            bestScore = score;
+                            best = &record;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (!best) return false;
+
+    bool mirrored = target.x < shooter.x;
+    angle = mirrored ? 180.0f - best->angle : best->angle;
+    power = best->power;
+    return true;
+}
+
+float ShotLog::profileSignature(const std::vector<float>& heights, sf::Vector2f shooter, sf::Vector2f target) {
+    if (heights.empty()) return 0.0f;
+
+    int last = static_cast<int>(heights.size()) - 1;
+    int first = std::clamp(static_cast<int>(std::min(shooter.x, target.x)), 0, last);
+    int end = std::clamp(static_cast<int>(std::max(shooter.x, target.x)), 0, last);
+
+    // Screen y grows downwards, so the highest ground is the smallest value
+    float peak = *std::min_element(heights.begin() + first, heights.begin() + end + 1);
+    return shooter.y - peak;
+}
@@ -0,0 +1,96 @@
+#include "../include/shot_log.h"
+#include "../include/shot_rules.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr int LOOKUPS = 1000000;
+
+    struct Situation {
+        sf::Vector2f shooter;
+        sf::Vector2f target;
+        float ridge;
+    };
+
+    // Tank spots spread over the same bands Game places tanks in, either side shooting
+    Situation randomSituation(std::mt19937& rng) {
+        const float width = static_cast<float>(ShotRules::WORLD_WIDTH);
+        std::uniform_real_distribution<float> leftBand(50.f, 200.f);
+        std::uniform_real_distribution<float> rightBand(width - 200.f, width - 50.f);
+        std::uniform_real_distribution<float> ground(250.f, 550.f);
+        std::uniform_real_distribution<float> ridge(0.f, 200.f);
+
+        sf::Vector2f left(leftBand(rng), ground(rng));
+        sf::Vector2f right(rightBand(rng), ground(rng));
+        bool leftShoots = rng() % 2 == 0;
+        return Situation{leftShoots ? left : right, leftShoots ? right : left, ridge(rng)};
+    }
+
+    double elapsedMicroseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+// Usage: ArtilleryShotLogBench [records] [path]
+// Fills a fresh shot log with random shots (mostly misses, about one in ten within
+// ShotLog::SUCCESS_DISTANCE), reopens it to time the index rebuild, then times
+// findNearest over random situations.
+int main(int argc, char* argv[]) {
+    std::size_t recordCount = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2000000;
+    std::string path = argc > 2 ? argv[2] : "shot_log_bench.bin";
+
+    try {
+        std::remove(path.c_str());
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> angleDist(0.0f, 180.0f);
+        std::uniform_real_distribution<float> powerDist(20.0f, 100.0f);
+        std::uniform_real_distribution<float> missDist(-500.0f, 500.0f);
+
+        {
+            ShotLog log(ShotRules::WORLD_WIDTH, ShotRules::WORLD_HEIGHT);
+            log.open(path);
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < recordCount; ++i) {
+                Situation situation = randomSituation(rng);
+                float miss = missDist(rng);
+                sf::Vector2f impact = situation.target + sf::Vector2f(miss, 0.0f);
+                log.append(situation.shooter, situation.target, situation.ridge,
+                           angleDist(rng), powerDist(rng), impact, false);
+            }
+            std::cout << "append: " << elapsedMicroseconds(start) / recordCount << " us/record" << std::endl;
+        }
+
+        ShotLog log(ShotRules::WORLD_WIDTH, ShotRules::WORLD_HEIGHT);
+        auto openStart = std::chrono::steady_clock::now();
+        log.open(path);
+        std::cout << "open: " << log.size() << " records indexed in "
+                  << elapsedMicroseconds(openStart) / 1000.0 << " ms" << std::endl;
+
+        std::vector<Situation> queries;
+        queries.reserve(LOOKUPS);
+        for (int i = 0; i < LOOKUPS; ++i) {
+            queries.push_back(randomSituation(rng));
+        }
+
+        int found = 0;
+        float angle, power;
+        auto lookupStart = std::chrono::steady_clock::now();
+        for (const Situation& query : queries) {
+            found += log.findNearest(query.shooter, query.target, query.ridge, angle, power);
+        }
+        std::cout << "findNearest: " << elapsedMicroseconds(lookupStart) / LOOKUPS << " us/lookup, "
+                  << found << " of " << LOOKUPS << " found" << std::endl;
+
+        log.close();
+        std::remove(path.c_str());
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,18 +1,157 @@
 #include "../include/terrain.h"
 #include <random>
 #include <cmath>
+#include <algorithm>
 
-Terrain::Terrain(int w, int h)
+// The batched queries have an AVX2 path built with explicit gathers. GCC and Clang
+// compile it for AVX2 regardless of the target flags and pick it at run time;
+// MSVC only when the whole build targets AVX2 (/arch:AVX2).
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TERRAIN_AVX2_PATH 1
+#define TERRAIN_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#define TERRAIN_AVX2_PATH 1
+#define TERRAIN_AVX2_TARGET
+#endif
+
+#ifdef TERRAIN_AVX2_PATH
+#include <immintrin.h>
+
+namespace {
+    bool hasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return true;
+#endif
+    }
+
+    // Eight queries per iteration: clamp x, split it into column and fraction, and
+    // gather the neighbouring heights. Every lane is clamped before the gather.
+    struct Lanes {
+        __m256 t;
+        __m256 h0;
+        __m256 h1;
+        __m256 h2;
+        __m256 h3;
+    };
+
+    TERRAIN_AVX2_TARGET inline __m256i clampColumns(__m256i i, __m256i last) {
+        return _mm256_min_epi32(_mm256_max_epi32(i, _mm256_setzero_si256()), last);
+    }
+
+    TERRAIN_AVX2_TARGET inline Lanes gatherLanes(const float* h, const float* xs, int lastColumn) {
+        const __m256i last = _mm256_set1_epi32(lastColumn);
+        const __m256i one = _mm256_set1_epi32(1);
+        __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(xs), _mm256_setzero_ps()),
+                                 _mm256_set1_ps(static_cast<float>(lastColumn)));
+        __m256i i = _mm256_cvttps_epi32(x);
+
+        Lanes lanes;
+        lanes.t = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+        lanes.h0 = _mm256_i32gather_ps(h, clampColumns(_mm256_sub_epi32(i, one), last), 4);
+        lanes.h1 = _mm256_i32gather_ps(h, i, 4);
+        lanes.h2 = _mm256_i32gather_ps(h, clampColumns(_mm256_add_epi32(i, one), last), 4);
+        lanes.h3 = _mm256_i32gather_ps(h, clampColumns(_mm256_add_epi32(i, _mm256_set1_epi32(2)), last), 4);
+        return lanes;
+    }
+
+    // Catmull-Rom coefficients, as in generate(): value = ((a*t + b)*t + c)*t + h1
+    TERRAIN_AVX2_TARGET inline void cubicCoefficients(const Lanes& l, __m256& a, __m256& b, __m256& c) {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        a = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(-0.5f), l.h0), _mm256_mul_ps(_mm256_set1_ps(-1.5f), l.h1)),
+                          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.5f), l.h2), _mm256_mul_ps(half, l.h3)));
+        b = _mm256_add_ps(_mm256_sub_ps(l.h0, _mm256_mul_ps(_mm256_set1_ps(2.5f), l.h1)),
+                          _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), l.h2), _mm256_mul_ps(half, l.h3)));
+        c = _mm256_mul_ps(half, _mm256_sub_ps(l.h2, l.h0));
+    }
+
+    // Each returns how many leading queries it handled; the scalar loops finish the rest
+    TERRAIN_AVX2_TARGET std::size_t heightsAvx2(const float* h, int lastColumn, const float* xs, float* out,
+                                                std::size_t count, Terrain::Interpolation mode) {
+        std::size_t n = 0;
+        for(; n + 8 <= count; n += 8) {
+            __m256 result;
+            if(mode == Terrain::Interpolation::Nearest) {
+                __m256i i = clampColumns(_mm256_cvttps_epi32(_mm256_loadu_ps(xs + n)), _mm256_set1_epi32(lastColumn));
+                result = _mm256_i32gather_ps(h, i, 4);
+            } else {
+                Lanes l = gatherLanes(h, xs + n, lastColumn);
+                if(mode == Terrain::Interpolation::Linear) {
+                    result = _mm256_add_ps(l.h1, _mm256_mul_ps(_mm256_sub_ps(l.h2, l.h1), l.t));
+                } else {
+                    __m256 a, b, c;
+                    cubicCoefficients(l, a, b, c);
+                    result = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(
+                                 _mm256_mul_ps(a, l.t), b), l.t), c), l.t), l.h1);
+                }
+            }
+            _mm256_storeu_ps(out + n, result);
+        }
+        return n;
+    }
+
+    TERRAIN_AVX2_TARGET std::size_t slopesAvx2(const float* h, int lastColumn, const float* xs, float* out,
+                                               std::size_t count, Terrain::Interpolation mode) {
+        std::size_t n = 0;
+        for(; n + 8 <= count; n += 8) {
+            __m256 result;
+            if(mode == Terrain::Interpolation::Nearest) {
+                // Central difference around the nearest column
+                const __m256i last = _mm256_set1_epi32(lastColumn);
+                const __m256i one = _mm256_set1_epi32(1);
+                __m256i i = clampColumns(_mm256_cvttps_epi32(_mm256_loadu_ps(xs + n)), last);
+                __m256 left = _mm256_i32gather_ps(h, clampColumns(_mm256_sub_epi32(i, one), last), 4);
+                __m256 right = _mm256_i32gather_ps(h, clampColumns(_mm256_add_epi32(i, one), last), 4);
+                result = _mm256_mul_ps(_mm256_sub_ps(right, left), _mm256_set1_ps(0.5f));
+            } else {
+                Lanes l = gatherLanes(h, xs + n, lastColumn);
+                if(mode == Terrain::Interpolation::Linear) {
+                    result = _mm256_sub_ps(l.h2, l.h1);
+                } else {
+                    // Derivative of the Catmull-Rom segment: (3a*t + 2b)*t + c
+                    __m256 a, b, c;
+                    cubicCoefficients(l, a, b, c);
+                    result = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(
+                                 _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), a), l.t),
+                                 _mm256_mul_ps(_mm256_set1_ps(2.0f), b)), l.t), c);
+                }
+            }
+            _mm256_storeu_ps(out + n, result);
+        }
+        return n;
+    }
+}
+#endif
+
+Terrain::Terrain(int w, int h, MeshMode mode)
     : width(w)
     , height(h)
     , heights(w)
-    , terrain(sf::TriangleStrip, w * 2) {
+    , terrain(sf::TriangleStrip, mode == MeshMode::Full ? w * 2 : 0)
+    , vertexCapacity(mode == MeshMode::Full ? w * 2 : 0)
+    , meshMode(mode)
+    , lodTolerance(DEFAULT_LOD_TOLERANCE) {
+
+    if(meshMode == MeshMode::Adaptive) {
+        reserveLodScratch();
+    }
+    // Headless terrains share a per-thread delta buffer instead (see craterScratch)
+    if(meshMode != MeshMode::None) {
+        craterDelta.assign(w, 0.0f);
+    }
+    craterRanges.reserve(MAX_BATCHED_IMPACTS);
 }
 
 void Terrain::generate() {
     // Use random seed for each generation
     std::random_device rd;
-    std::mt19937 gen(rd());
+    generate(rd());
+}
+
+void Terrain::generate(std::uint32_t seed) {
+    std::mt19937 gen(seed);
     std::uniform_real_distribution<float> noiseDist(-1.0f, 1.0f);
 
     // Generate random control points
@@ -56,20 +195,19 @@ void Terrain::generate() {
         smoothTerrain();
     }
 
-    updateVertexArray();
+    rebuildMesh();
 }
 
 void Terrain::smoothTerrain() {
-    std::vector<float> smoothedHeights = heights;
-
-    // Apply moving average smoothing
+    // Apply moving average smoothing in place, carrying the unsmoothed left neighbour
+    float previous = heights[0];
     for(int i = 1; i < width - 1; ++i) {
-        smoothedHeights[i] = heights[i-1] * SMOOTHING_FACTOR +
-                            heights[i] * (1 - 2 * SMOOTHING_FACTOR) +
-                            heights[i+1] * SMOOTHING_FACTOR;
+        float current = heights[i];
+        heights[i] = previous * SMOOTHING_FACTOR +
+                     current * (1 - 2 * SMOOTHING_FACTOR) +
+                     heights[i+1] * SMOOTHING_FACTOR;
+        previous = current;
     }
-
-    heights = smoothedHeights;
 }
 
 float Terrain::generateSmoothNoise(int x) const {
@@ -83,20 +221,128 @@ void Terrain::draw(sf::RenderWindow& window) const {
     window.draw(terrain);
 }
 
-void Terrain::deform(const sf::Vector2f& impact, float radius) {
-    int center = static_cast<int>(impact.x);
-    int start = std::max(0, center - static_cast<int>(radius));
-    int end = std::min(width - 1, center + static_cast<int>(radius));
+void Terrain::draw(sf::RenderWindow& window, float left, float right) const {
+    std::size_t firstVertex;
+    std::size_t lastVertex;
+
+    if(meshMode == MeshMode::Adaptive && !meshColumns.empty()) {
+        // Kept columns are x-sorted, so include one column beyond each edge
+        auto first = std::lower_bound(meshColumns.begin(), meshColumns.end(), static_cast<int>(left));
+        if(first != meshColumns.begin()) --first;
+        auto last = std::upper_bound(meshColumns.begin(), meshColumns.end(), static_cast<int>(right));
+        if(last == meshColumns.end()) --last;
+        firstVertex = (first - meshColumns.begin()) * 2;
+        lastVertex = (last - meshColumns.begin()) * 2 + 1;
+    } else {
+        int first = std::clamp(static_cast<int>(left) - 1, 0, width - 1);
+        int last = std::clamp(static_cast<int>(right) + 1, 0, width - 1);
+        firstVertex = first * 2;
+        lastVertex = last * 2 + 1;
+    }
+
+    if(lastVertex >= terrain.getVertexCount() || firstVertex > lastVertex) return;
+    window.draw(&terrain[firstVertex], lastVertex - firstVertex + 1, sf::TriangleStrip);
+}
+
+Terrain::ColumnRange Terrain::deform(const sf::Vector2f& impact, float radius) {
+    Impact single;
+    single.position = impact;
+    single.radius = radius;
+    return deformBatch(std::span<const Impact>(&single, 1));
+}
+
+Terrain::ColumnRange Terrain::deformBatch(std::span<const Impact> impacts) {
+    craterRanges.clear();
+    ColumnRange changed{width, -1};
+    float* deltaBase = craterScratch();
 
-    for(int i = start; i <= end; ++i) {
-        float distance = std::abs(i - center);
-        float factor = 1.0f - (distance / radius);
-        if(factor > 0) {
-            heights[i] += 20.0f * factor;
+    // Accumulate every impact into the shared delta buffer
+    for(const Impact& impact : impacts) {
+        int center = static_cast<int>(impact.position.x);
+        int start = std::max(0, center - static_cast<int>(impact.radius));
+        int end = std::min(width - 1, center + static_cast<int>(impact.radius));
+        if(start > end || impact.radius <= 0) continue;
+
+        // Branch on the profile once per impact so the column loops stay vectorizable
+        float inverseRadius = 1.0f / impact.radius;
+        float* delta = deltaBase;
+        switch(impact.profile) {
+            case CraterProfile::Circular:
+                for(int i = start; i <= end; ++i) {
+                    float t = std::abs(static_cast<float>(i - center)) * inverseRadius;
+                    delta[i] += impact.depth * std::sqrt(std::max(0.0f, 1.0f - t * t));
+                }
+                break;
+            case CraterProfile::Custom:
+                for(int i = start; i <= end; ++i) {
+                    // Signed offset, so asymmetric kernels keep their left and right halves
+                    float t = static_cast<float>(i - center) * inverseRadius;
+                    delta[i] += impact.depth * sampleKernel(impact.kernel, t);
+                }
+                break;
+            case CraterProfile::Linear:
+            default:
+                for(int i = start; i <= end; ++i) {
+                    float t = std::abs(static_cast<float>(i - center)) * inverseRadius;
+                    delta[i] += impact.depth * std::max(0.0f, 1.0f - t);
+                }
+                break;
         }
+
+        craterRanges.push_back(ColumnRange{start, end});
+        changed.first = std::min(changed.first, start);
+        changed.last = std::max(changed.last, end);
     }
+    if(craterRanges.empty()) return changed;
 
-    updateVertexArray();
+    // Merge overlapping and touching ranges
+    std::sort(craterRanges.begin(), craterRanges.end(),
+              [](const ColumnRange& a, const ColumnRange& b) { return a.first < b.first; });
+    std::size_t merged = 0;
+    for(std::size_t i = 1; i < craterRanges.size(); ++i) {
+        if(craterRanges[i].first <= craterRanges[merged].last + 1) {
+            craterRanges[merged].last = std::max(craterRanges[merged].last, craterRanges[i].last);
+        } else {
+            craterRanges[++merged] = craterRanges[i];
+        }
+    }
+    craterRanges.resize(merged + 1);
+
+    // Single pass over each merged range, clearing the delta for the next batch
+    for(const ColumnRange& range : craterRanges) {
+        float* column = heights.data() + range.first;
+        float* delta = deltaBase + range.first;
+        int count = range.last - range.first + 1;
+        for(int i = 0; i < count; ++i) {
+            column[i] += delta[i];
+            delta[i] = 0.0f;
+        }
+    }
+
+    updateMeshRanges(craterRanges);
+    return changed;
+}
+
+float* Terrain::craterScratch() {
+    if(!craterDelta.empty()) return craterDelta.data();
+
+    // Every batch leaves the delta zeroed, so terrains on one thread can take turns with it
+    thread_local std::vector<float> sharedDelta;
+    if(sharedDelta.size() < static_cast<std::size_t>(width)) {
+        sharedDelta.resize(width, 0.0f);
+    }
+    return sharedDelta.data();
+}
+
+float Terrain::sampleKernel(std::span<const float> kernel, float t) {
+    if(kernel.empty() || t < -1.0f || t > 1.0f) return 0.0f;
+
+    // t runs from -1 (left edge) to 1 (right edge); the kernel's first entry is the left edge
+    float position = (0.5f + 0.5f * t) * (kernel.size() - 1);
+    std::size_t index = static_cast<std::size_t>(position);
+    if(index + 1 >= kernel.size()) return kernel.back();
+    float frac = position - index;
+    return kernel[index] + (kernel[index + 1] - kernel[index]) * frac;
 }
 
 float Terrain::getHeightAt(float x) const {
@@ -106,19 +352,283 @@ float Terrain::getHeightAt(float x) const {
     return heights[index];
 }
 
+// The batched queries clamp instead of branching. The AVX2 path handles whole groups
+// of eight; the scalar loops below handle the tail, or everything without AVX2.
+void Terrain::getHeightsAt(std::span<const float> xs, std::span<float> out, Interpolation mode) const {
+    const float* h = heights.data();
+    const int lastColumn = width - 1;
+    const float maxX = static_cast<float>(lastColumn);
+    const std::size_t count = std::min(xs.size(), out.size());
+
+    std::size_t n = 0;
+#ifdef TERRAIN_AVX2_PATH
+    if(hasAvx2()) {
+        n = heightsAvx2(h, lastColumn, xs.data(), out.data(), count, mode);
+    }
+#endif
+
+    switch(mode) {
+        case Interpolation::Nearest:
+            for(; n < count; ++n) {
+                int i = std::clamp(static_cast<int>(xs[n]), 0, lastColumn);
+                out[n] = h[i];
+            }
+            break;
+        case Interpolation::Linear:
+            for(; n < count; ++n) {
+                float x = std::clamp(xs[n], 0.0f, maxX);
+                int i = static_cast<int>(x);
+                int i1 = std::min(i + 1, lastColumn);
+                float t = x - i;
+                out[n] = h[i] + (h[i1] - h[i]) * t;
+            }
+            break;
+        case Interpolation::Cubic:
+            for(; n < count; ++n) {
+                float x = std::clamp(xs[n], 0.0f, maxX);
+                int i = static_cast<int>(x);
+                float t = x - i;
+                float h0 = h[std::max(i - 1, 0)];
+                float h1 = h[i];
+                float h2 = h[std::min(i + 1, lastColumn)];
+                float h3 = h[std::min(i + 2, lastColumn)];
+
+                // Catmull-Rom, as used by generate()
+                float t2 = t * t;
+                float t3 = t2 * t;
+                out[n] = (-0.5f * h0 + 1.5f * h1 - 1.5f * h2 + 0.5f * h3) * t3 +
+                         (h0 - 2.5f * h1 + 2.0f * h2 - 0.5f * h3) * t2 +
+                         (-0.5f * h0 + 0.5f * h2) * t +
+                         h1;
+            }
+            break;
+    }
+}
+
+void Terrain::getSlopesAt(std::span<const float> xs, std::span<float> out, Interpolation mode) const {
+    const float* h = heights.data();
+    const int lastColumn = width - 1;
+    const float maxX = static_cast<float>(lastColumn);
+    const std::size_t count = std::min(xs.size(), out.size());
+
+    std::size_t n = 0;
+#ifdef TERRAIN_AVX2_PATH
+    if(hasAvx2()) {
+        n = slopesAvx2(h, lastColumn, xs.data(), out.data(), count, mode);
+    }
+#endif
+
+    switch(mode) {
+        case Interpolation::Nearest:
+            // Central difference around the nearest column
+            for(; n < count; ++n) {
+                int i = std::clamp(static_cast<int>(xs[n]), 0, lastColumn);
+                out[n] = (h[std::min(i + 1, lastColumn)] - h[std::max(i - 1, 0)]) * 0.5f;
+            }
+            break;
+        case Interpolation::Linear:
+            for(; n < count; ++n) {
+                int i = static_cast<int>(std::clamp(xs[n], 0.0f, maxX));
+                out[n] = h[std::min(i + 1, lastColumn)] - h[i];
+            }
+            break;
+        case Interpolation::Cubic:
+            for(; n < count; ++n) {
+                float x = std::clamp(xs[n], 0.0f, maxX);
+                int i = static_cast<int>(x);
+                float t = x - i;
+                float h0 = h[std::max(i - 1, 0)];
+                float h1 = h[i];
+                float h2 = h[std::min(i + 1, lastColumn)];
+                float h3 = h[std::min(i + 2, lastColumn)];
+
+                // Derivative of the Catmull-Rom segment
+                out[n] = 3.0f * (-0.5f * h0 + 1.5f * h1 - 1.5f * h2 + 0.5f * h3) * t * t +
+                         2.0f * (h0 - 2.5f * h1 + 2.0f * h2 - 0.5f * h3) * t +
+                         (-0.5f * h0 + 0.5f * h2);
+            }
+            break;
+    }
+}
+
+void Terrain::getNormalsAt(std::span<const float> xs, std::span<sf::Vector2f> out, Interpolation mode) const {
+    const std::size_t count = std::min(xs.size(), out.size());
+
+    // Work through a stack buffer of slopes so normals need no heap scratch
+    for(std::size_t start = 0; start < count; start += NORMAL_BATCH) {
+        std::size_t batch = std::min(NORMAL_BATCH, count - start);
+        float slopes[NORMAL_BATCH];
+        getSlopesAt(xs.subspan(start, batch), std::span<float>(slopes, batch), mode);
+
+        for(std::size_t n = 0; n < batch; ++n) {
+            float inverseLength = 1.0f / std::sqrt(1.0f + slopes[n] * slopes[n]);
+            out[start + n] = sf::Vector2f(slopes[n] * inverseLength, -inverseLength);
+        }
+    }
+}
+
+const std::vector<float>& Terrain::getHeights() const {
+    return heights;
+}
+
 bool Terrain::isCollision(const sf::Vector2f& point) const {
     if(point.x < 0 || point.x >= width) return false;
     return point.y >= getHeightAt(point.x);
 }
 
+void Terrain::setMeshMode(MeshMode mode, float tolerance) {
+    if(mode == MeshMode::Adaptive) {
+        reserveLodScratch();
+    }
+    if(mode != MeshMode::None && craterDelta.empty()) {
+        craterDelta.assign(width, 0.0f);
+    }
+    meshMode = mode;
+    lodTolerance = tolerance;
+    rebuildMesh();
+}
+
+Terrain::MeshStats Terrain::getMeshStats() const {
+    MeshStats stats;
+    stats.fullVertexCount = static_cast<std::size_t>(width) * 2;
+    stats.vertexCount = terrain.getVertexCount();
+    stats.fullBytes = stats.fullVertexCount * sizeof(sf::Vertex);
+    stats.heldBytes = vertexCapacity * sizeof(sf::Vertex) +
+                      meshColumns.capacity() * sizeof(int) +
+                      lodScratch.capacity() * sizeof(int) +
+                      lodStack.capacity() * sizeof(std::pair<int, int>);
+    return stats;
+}
+
+std::size_t Terrain::getMemoryFootprint() const {
+    return sizeof(Terrain) +
+           heights.capacity() * sizeof(float) +
+           vertexCapacity * sizeof(sf::Vertex) +
+           meshColumns.capacity() * sizeof(int) +
+           lodScratch.capacity() * sizeof(int) +
+           lodStack.capacity() * sizeof(std::pair<int, int>) +
+           craterDelta.capacity() * sizeof(float) +
+           craterRanges.capacity() * sizeof(ColumnRange);
+}
+
+void Terrain::reserveLodScratch() {
+    // Reserve worst-case sizes so re-simplification never reallocates
+    meshColumns.reserve(width);
+    lodScratch.reserve(width);
+    lodStack.reserve(width);
+
+    // sf::VertexArray has no reserve(); growing it to the full mesh once keeps
+    // that capacity when the adaptive mesh later shrinks and regrows
+    resizeVertices(static_cast<std::size_t>(width) * 2);
+}
+
+void Terrain::rebuildMesh() {
+    meshColumns.clear();
+    if(meshMode == MeshMode::Adaptive && width > 1) {
+        // Endpoints are always kept, everything in between is simplified
+        simplifyRange(0, width - 1);
+        meshColumns.push_back(0);
+        meshColumns.insert(meshColumns.end(), lodScratch.begin(), lodScratch.end());
+        meshColumns.push_back(width - 1);
+    }
+
+    updateVertexArray();
+}
+
+void Terrain::updateMeshRanges(std::span<const ColumnRange> ranges) {
+    if(meshMode == MeshMode::None) return;
+
+    if(meshMode == MeshMode::Full || width <= 1) {
+        for(const ColumnRange& range : ranges) {
+            for(int i = range.first; i <= range.last; ++i) {
+                writeColumn(i * 2, i);
+            }
+        }
+        return;
+    }
+
+    for(const ColumnRange& range : ranges) {
+        resimplifyRange(range.first, range.last);
+    }
+    updateVertexArray();
+}
+
+void Terrain::resimplifyRange(int start, int end) {
+    // Find the nearest kept columns outside the dirty range to anchor re-simplification
+    auto first = std::lower_bound(meshColumns.begin(), meshColumns.end(), start);
+    if(first != meshColumns.begin()) --first;
+    auto last = std::upper_bound(meshColumns.begin(), meshColumns.end(), end);
+    if(last == meshColumns.end()) --last;
+
+    simplifyRange(*first, *last);
+
+    // Replace only the columns between the anchors
+    auto erased = meshColumns.erase(first + 1, last);
+    meshColumns.insert(erased, lodScratch.begin(), lodScratch.end());
+}
+
+void Terrain::simplifyRange(int first, int last) {
+    // Douglas-Peucker on the height profile, using vertical distance as the error
+    lodScratch.clear();
+    lodStack.clear();
+    lodStack.emplace_back(first, last);
+
+    while(!lodStack.empty()) {
+        auto [a, b] = lodStack.back();
+        lodStack.pop_back();
+
+        float slope = (heights[b] - heights[a]) / static_cast<float>(b - a);
+        float maxError = 0.0f;
+        int split = -1;
+        for(int i = a + 1; i < b; ++i) {
+            float error = std::abs(heights[i] - (heights[a] + slope * (i - a)));
+            if(error > maxError) {
+                maxError = error;
+                split = i;
+            }
+        }
+
+        if(split >= 0 && maxError > lodTolerance) {
+            lodScratch.push_back(split);
+            lodStack.emplace_back(a, split);
+            lodStack.emplace_back(split, b);
+        }
+    }
+
+    std::sort(lodScratch.begin(), lodScratch.end());
+}
+
 void Terrain::updateVertexArray() {
-    for(int i = 0; i < width; ++i) {
-        // Top vertex
-        terrain[i*2].position = sf::Vector2f(i, heights[i]);
-        terrain[i*2].color = sf::Color(34, 139, 34); // Forest green
+    if(meshMode == MeshMode::None) {
+        terrain.clear();
+        return;
+    }
 
-        // Bottom vertex
-        terrain[i*2+1].position = sf::Vector2f(i, height);
-        terrain[i*2+1].color = sf::Color(139, 69, 19); // Saddle brown
+    if(meshMode == MeshMode::Adaptive && !meshColumns.empty()) {
+        resizeVertices(meshColumns.size() * 2);
+        for(std::size_t i = 0; i < meshColumns.size(); ++i) {
+            writeColumn(static_cast<int>(i * 2), meshColumns[i]);
+        }
+        return;
     }
+
+    resizeVertices(static_cast<std::size_t>(width) * 2);
+    for(int i = 0; i < width; ++i) {
+        writeColumn(i * 2, i);
+    }
+}
+
+void Terrain::resizeVertices(std::size_t count) {
+    terrain.resize(count);
+    vertexCapacity = std::max(vertexCapacity, count);
+}
+
+void Terrain::writeColumn(int vertexIndex, int column) {
+    // Top vertex
+    terrain[vertexIndex].position = sf::Vector2f(column, heights[column]);
+    terrain[vertexIndex].color = sf::Color(34, 139, 34); // Forest green
+
+    // Bottom vertex
+    terrain[vertexIndex+1].position = sf::Vector2f(column, height);
+    terrain[vertexIndex+1].color = sf::Color(139, 69, 19); // Saddle brown
 }
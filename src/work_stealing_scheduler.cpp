@@ -0,0 +1,118 @@
+#include "../include/work_stealing_scheduler.h"
+#include <algorithm>
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned threadCount)
+    : jobFunction(nullptr)
+    , jobContext(nullptr)
+    , jobRound(0)
+    , busyWorkers(0)
+    , steals(0) {
+
+    unsigned count = std::max(1u, threadCount);
+    for (unsigned i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // Queue 0 belongs to the thread calling parallelFor
+    for (unsigned i = 1; i < count; ++i) {
+        workers.emplace_back([this, i](std::stop_token stopToken) { workerLoop(i, stopToken); });
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    for (auto& worker : workers) {
+        worker.request_stop();
+    }
+}
+
+unsigned WorkStealingScheduler::getThreadCount() const {
+    return static_cast<unsigned>(queues.size());
+}
+
+std::uint64_t WorkStealingScheduler::getStealCount() const {
+    return steals.load(std::memory_order_relaxed);
+}
+
+void WorkStealingScheduler::run(std::size_t count, std::size_t grain, RangeFunction function, void* context) {
+    if (count == 0) return;
+    grain = std::max<std::size_t>(1, grain);
+
+    // Deal chunks round-robin; the range vectors keep their capacity between calls
+    for (auto& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->ranges.clear();
+        queue->head = 0;
+        queue->tail = 0;
+    }
+    std::size_t chunk = 0;
+    for (std::size_t begin = 0; begin < count; begin += grain, ++chunk) {
+        WorkerQueue& queue = *queues[chunk % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.ranges.push_back(Range{begin, std::min(count, begin + grain)});
+        queue.tail = queue.ranges.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobFunction = function;
+        jobContext = context;
+        busyWorkers = static_cast<unsigned>(workers.size());
+        jobRound++;
+    }
+    wakeup.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+void WorkStealingScheduler::workerLoop(unsigned index, std::stop_token stopToken) {
+    std::uint64_t seenRound = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!wakeup.wait(lock, stopToken, [&] { return jobRound != seenRound; })) {
+                return;
+            }
+            seenRound = jobRound;
+        }
+
+        drain(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void WorkStealingScheduler::drain(unsigned index) {
+    Range range;
+    while (takeOwn(index, range) || steal(index, range)) {
+        jobFunction(jobContext, range.begin, range.end);
+    }
+}
+
+bool WorkStealingScheduler::takeOwn(unsigned index, Range& range) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.head == queue.tail) return false;
+
+    range = queue.ranges[--queue.tail];
+    return true;
+}
+
+bool WorkStealingScheduler::steal(unsigned thief, Range& range) {
+    const unsigned count = static_cast<unsigned>(queues.size());
+    for (unsigned offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.head == victim.tail) continue;
+
+        range = victim.ranges[victim.head++];
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}